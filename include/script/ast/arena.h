@@ -0,0 +1,126 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBSCRIPT_AST_ARENA_H
+#define LIBSCRIPT_AST_ARENA_H
+
+#include "libscriptdefs.h"
+
+#include <memory>
+#include <vector>
+
+namespace script
+{
+
+namespace ast
+{
+
+/*!
+ * \class Arena
+ * \brief bump allocator for the nodes of an AST
+ *
+ * Memory is obtained from the system in large blocks and is only released, 
+ * all at once, when the Arena is destroyed.
+ * An Arena is not thread-safe.
+ */
+class LIBSCRIPT_API Arena
+{
+public:
+  Arena();
+  Arena(const Arena&) = delete;
+  ~Arena();
+
+  void* allocate(size_t size, size_t alignment);
+
+  void adopt(std::shared_ptr<Arena> other);
+
+  size_t bytesAllocated() const;
+  size_t bytesReserved() const;
+
+  static Arena* current();
+
+  Arena& operator=(const Arena&) = delete;
+
+private:
+  friend class ArenaScope;
+  std::vector<std::unique_ptr<char[]>> m_blocks;
+  char* m_ptr;
+  char* m_end;
+  size_t m_allocated;
+  size_t m_reserved;
+  std::vector<std::shared_ptr<Arena>> m_adopted;
+};
+
+/*!
+ * \class ArenaScope
+ * \brief makes an arena the current arena of the calling thread
+ *
+ * While an ArenaScope is alive, the nodes created by the New() functions 
+ * of the ast namespace are allocated in its arena.
+ */
+class LIBSCRIPT_API ArenaScope
+{
+public:
+  explicit ArenaScope(std::shared_ptr<Arena> arena);
+  ArenaScope(const ArenaScope&) = delete;
+  ~ArenaScope();
+
+  static const std::shared_ptr<Arena>& current();
+
+  ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+  std::shared_ptr<Arena> m_previous;
+};
+
+/*!
+ * \struct ArenaAllocator
+ * \brief allocator of the nodes created by make_node()
+ *
+ * Each allocation keeps the arena alive, so that nodes that outlive 
+ * their AST (e.g. nodes obtained from Ast::statements()) remain valid.
+ */
+template<typename T>
+struct ArenaAllocator
+{
+  typedef T value_type;
+
+  std::shared_ptr<Arena> arena;
+
+  explicit ArenaAllocator(std::shared_ptr<Arena> a) : arena(std::move(a)) { }
+
+  template<typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) { }
+
+  T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T*, size_t) { }
+
+  template<typename U>
+  bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+  template<typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+/*!
+ * \fn std::shared_ptr<T> make_node(Args&&... args)
+ * \brief creates an AST node
+ *
+ * The node is allocated in the current arena if there is one.
+ */
+template<typename T, typename...Args>
+std::shared_ptr<T> make_node(Args&&... args)
+{
+  const std::shared_ptr<Arena>& arena = ArenaScope::current();
+
+  if (arena)
+    return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+  else
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+} // namespace ast
+
+} // namespace script
+
+#endif // LIBSCRIPT_AST_ARENA_H
@@ -6,6 +6,7 @@
 #define LIBSCRIPT_AST_P_H
 
 #include "script/sourcefile.h"
+#include "script/ast/arena.h"
 #include "script/ast/node.h"
 
 #include "script/diagnosticmessage.h"
@@ -34,9 +35,11 @@ public:
   SourceFile::Position position(const parser::Token& tok) const;
 
 public:
+  std::shared_ptr<Arena> arena; // storage of the nodes, must be destroyed last
   std::shared_ptr<ast::Node> root;
   std::weak_ptr<ScriptImpl> script;
   SourceFile source;
+
 };
 
 } // namespace ast
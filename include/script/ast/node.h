@@ -13,6 +13,8 @@
 
 #include "script/operators.h"
 
+#include "script/ast/arena.h"
+
 namespace script
 {
 
@@ -137,7 +139,7 @@ public:
 
   inline static std::shared_ptr<BoolLiteral> New(const parser::Token & tok)
   {
-    return std::make_shared<BoolLiteral>(tok);
+    return make_node<BoolLiteral>(tok);
   }
 
   static const NodeType type_code = NodeType::BoolLiteral;
@@ -152,7 +154,7 @@ public:
 
   inline static std::shared_ptr<IntegerLiteral> New(const parser::Token & tok)
   {
-    return std::make_shared<IntegerLiteral>(tok);
+    return make_node<IntegerLiteral>(tok);
   }
 
   static const NodeType type_code = NodeType::IntegerLiteral;
@@ -167,7 +169,7 @@ public:
 
   inline static std::shared_ptr<FloatingPointLiteral> New(const parser::Token & tok)
   {
-    return std::make_shared<FloatingPointLiteral>(tok);
+    return make_node<FloatingPointLiteral>(tok);
   }
 
   static const NodeType type_code = NodeType::FloatingPointLiteral;
@@ -182,7 +184,7 @@ public:
 
   inline static std::shared_ptr<StringLiteral> New(const parser::Token & tok)
   {
-    return std::make_shared<StringLiteral>(tok);
+    return make_node<StringLiteral>(tok);
   }
 
   static const NodeType type_code = NodeType::StringLiteral;
@@ -197,7 +199,7 @@ public:
 
   inline static std::shared_ptr<UserDefinedLiteral> New(const parser::Token & tok)
   {
-    return std::make_shared<UserDefinedLiteral>(tok);
+    return make_node<UserDefinedLiteral>(tok);
   }
 
   static const NodeType type_code = NodeType::UserDefinedLiteral;
@@ -221,7 +223,7 @@ public:
 
   inline static std::shared_ptr<SimpleIdentifier> New(const parser::Token & name)
   {
-    return std::make_shared<SimpleIdentifier>(name);
+    return make_node<SimpleIdentifier>(name);
   }
 
   std::string getName() const;
@@ -250,7 +252,7 @@ public:
 
   inline static std::shared_ptr<TemplateIdentifier> New(const parser::Token & name, const std::vector<NodeRef> & args, const parser::Token & la, const parser::Token & ra)
   {
-    return std::make_shared<TemplateIdentifier>(name, args, la, ra);
+    return make_node<TemplateIdentifier>(name, args, la, ra);
   }
 
   std::string getName() const;
@@ -275,7 +277,7 @@ public:
 
   inline static std::shared_ptr<OperatorName> New(const parser::Token & opkeyword, const parser::Token & opSymbol)
   {
-    return std::make_shared<OperatorName>(opkeyword, opSymbol);
+    return make_node<OperatorName>(opkeyword, opSymbol);
   }
 
   enum BuiltInOpResol {
@@ -311,7 +313,7 @@ public:
 
   inline static std::shared_ptr<LiteralOperatorName> New(const parser::Token & opkeyword, const parser::Token & dquotes, const parser::Token & suffixName)
   {
-    return std::make_shared<LiteralOperatorName>(opkeyword, dquotes, suffixName);
+    return make_node<LiteralOperatorName>(opkeyword, dquotes, suffixName);
   }
 
   inline const parser::Token & suffixName() const { return this->suffix; }
@@ -340,7 +342,7 @@ public:
 
   inline static std::shared_ptr<ScopedIdentifier> New(const std::shared_ptr<Identifier> & l, const parser::Token & scopeRes, const std::shared_ptr<Identifier> & r)
   {
-    return std::make_shared<ScopedIdentifier>(l, scopeRes, r);
+    return make_node<ScopedIdentifier>(l, scopeRes, r);
   }
 
   static std::shared_ptr<ScopedIdentifier> New(const std::vector<std::shared_ptr<Identifier>>::const_iterator & begin, const std::vector<std::shared_ptr<Identifier>>::const_iterator & end);
@@ -886,7 +888,7 @@ public:
 
   inline static std::shared_ptr<TypeNode> New(const QualifiedType &t)
   {
-    return std::make_shared<TypeNode>(t);
+    return make_node<TypeNode>(t);
   }
 
   parser::Token base_token() const override;
@@ -940,7 +942,7 @@ public:
 
   inline static std::shared_ptr<ClassDecl> New(const parser::Token& classK, const std::shared_ptr<Identifier> & cname)
   {
-    return std::make_shared<ClassDecl>(classK, cname);
+    return make_node<ClassDecl>(classK, cname);
   }
 
   parser::Token base_token() const override
@@ -968,7 +970,7 @@ public:
 
   inline static std::shared_ptr<AccessSpecifier> New(const parser::Token& visibility, const parser::Token& colon)
   {
-    return std::make_shared<AccessSpecifier>(visibility, colon);
+    return make_node<AccessSpecifier>(visibility, colon);
   }
 
   parser::Token base_token() const override
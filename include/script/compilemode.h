@@ -18,6 +18,17 @@ enum class CompileMode
   Debug,
 };
 
+/*!
+ * \enum RetentionPolicy
+ * \brief describes what is kept in memory after a script is compiled
+ */
+enum class RetentionPolicy
+{
+  KeepAll, // keep the ast and the source
+  KeepSource, // keep the source, discard the ast
+  DropAll, // discard the ast and unload the source
+};
+
 } // namespace script
 
 #endif // LIBSCRIPT_COMPILEMODE_H
@@ -22,6 +22,7 @@ class Engine;
 class Function;
 class Scope;
 class Script;
+class SourceFile;
 class TemplateArgument;
 
 namespace ast
@@ -44,7 +45,9 @@ namespace compiler
 
 class Compiler;
 class CompileSession;
+struct CompileFunctionTask;
 class FunctionCompiler;
+class Profiler;
 class ScriptCompiler;
 class SessionManager;
 
@@ -53,6 +56,7 @@ class LIBSCRIPT_API SessionManager
 private:
   Compiler* mCompiler;
   bool mStartedSession;
+  Profiler* mPreviousProfiler = nullptr;
 
 public:
   explicit SessionManager(Compiler* c);
@@ -60,6 +64,9 @@ public:
   ~SessionManager();
 
   inline bool started_session() const { return mStartedSession; }
+
+private:
+  void start_profiling();
 };
 
 class LIBSCRIPT_API Compiler
@@ -74,7 +81,19 @@ public:
 
   bool hasActiveSession() const;
 
+  size_t threadCount() const { return mThreadCount; }
+  void setThreadCount(size_t n);
+
+  bool lazyCompilation() const { return mLazyCompilation; }
+  void setLazyCompilation(bool on = true);
+
+  Profiler& profiler();
+  const Profiler& profiler() const;
+
   bool compile(Script s, CompileMode mode);
+  bool compile(const Function& f);
+  bool compileAll(Script s);
+  bool recompile(Script s, const SourceFile& src, CompileMode mode);
 
   void addToSession(Script s);
 
@@ -86,6 +105,8 @@ private:
   ScriptCompiler * getScriptCompiler();
   FunctionCompiler * getFunctionCompiler();
   void processAllDeclarations();
+  void compileFunctions();
+  bool compileDeferred(const CompileFunctionTask& task);
   void finalizeSession();
 
 private:
@@ -95,6 +116,9 @@ private:
   std::shared_ptr<CompileSession> mSession;
   std::unique_ptr<ScriptCompiler> mScriptCompiler;
   std::unique_ptr<FunctionCompiler> mFunctionCompiler;
+  std::unique_ptr<Profiler> mProfiler;
+  size_t mThreadCount = 1;
+  bool mLazyCompilation = false;
 };
 
 } // namespace compiler
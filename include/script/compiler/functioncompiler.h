@@ -64,6 +64,7 @@ public:
   bool isDebugCompilation() const;
 
   void compile(const CompileFunctionTask & task);
+  std::shared_ptr<program::CompoundStatement> compileBody(const CompileFunctionTask & task);
 
   Script script();
 
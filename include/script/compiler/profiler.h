@@ -0,0 +1,124 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBSCRIPT_COMPILER_PROFILER_H
+#define LIBSCRIPT_COMPILER_PROFILER_H
+
+#include "libscriptdefs.h"
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace script
+{
+
+namespace compiler
+{
+
+/*!
+ * \class Profiler
+ * \brief measures the time spent in the phases of a compilation
+ *
+ * A profiler is disabled by default.
+ * While it is enabled, the compiler that owns it records an event for
+ * each script, declaration, function body and template instance it
+ * processes, and updates a counter for each phase.
+ * Name lookups only update their counter.
+ *
+ * Only the thread that started the compile session is profiled;
+ * functions compiled in parallel are recorded as a single event per batch.
+ *
+ * At most MaxEvents events are stored, the following ones only update 
+ * the counters until the profiler is cleared.
+ */
+class LIBSCRIPT_API Profiler
+{
+public:
+  Profiler();
+  Profiler(const Profiler &) = delete;
+  ~Profiler();
+
+  enum class Phase
+  {
+    Compilation,
+    Parsing,
+    Declarations,
+    PendingDeclarations,
+    DefaultArguments,
+    FunctionBodies,
+    TemplateInstantiation,
+    NameLookup,
+  };
+
+  static const size_t PhaseCount = static_cast<size_t>(Phase::NameLookup) + 1;
+  static const size_t MaxEvents = 65536;
+
+  struct Event
+  {
+    Phase phase;
+    std::string name;
+    std::chrono::nanoseconds start;
+    std::chrono::nanoseconds duration;
+  };
+
+  struct Counter
+  {
+    size_t count = 0;
+    std::chrono::nanoseconds time{ 0 };
+  };
+
+  bool isEnabled() const { return m_enabled; }
+  void setEnabled(bool on = true);
+
+  const std::vector<Event> & events() const { return m_events; }
+  size_t droppedEvents() const { return m_dropped_events; }
+  const Counter & counter(Phase p) const;
+  std::vector<Event> slowest(Phase p, size_t n) const;
+
+  void clear();
+
+  void writeChromeTrace(std::ostream & out) const;
+
+  static const char* name(Phase p);
+
+  static Profiler* current();
+  static void setCurrent(Profiler* p);
+
+  class LIBSCRIPT_API Timer
+  {
+  public:
+    explicit Timer(Phase p);
+    Timer(const Timer &) = delete;
+    ~Timer();
+
+    bool isActive() const { return m_profiler != nullptr; }
+    void setName(std::string name) { m_name = std::move(name); }
+
+    Timer & operator=(const Timer &) = delete;
+
+  private:
+    Profiler* m_profiler;
+    Phase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+    std::string m_name;
+  };
+
+  Profiler & operator=(const Profiler &) = delete;
+
+private:
+  bool m_enabled = false;
+  std::chrono::steady_clock::time_point m_origin;
+  std::vector<Event> m_events;
+  size_t m_dropped_events = 0;
+  Counter m_counters[PhaseCount];
+  int m_depths[PhaseCount] = {};
+};
+
+} // namespace compiler
+
+} // namespace script
+
+#endif // LIBSCRIPT_COMPILER_PROFILER_H
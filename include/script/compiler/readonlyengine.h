@@ -0,0 +1,59 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBSCRIPT_COMPILER_READONLYENGINE_H
+#define LIBSCRIPT_COMPILER_READONLYENGINE_H
+
+#include "libscriptdefs.h"
+
+namespace script
+{
+
+namespace compiler
+{
+
+/*!
+ * \class DeferredCompilation
+ * \brief thrown when a function compiled against a read-only engine needs to modify it
+ *
+ * This type does not derive from std::exception so that it is not
+ * caught by the handlers of the compiler.
+ */
+class DeferredCompilation
+{
+public:
+  DeferredCompilation() = default;
+};
+
+/*!
+ * \class ReadOnlyEngine
+ * \brief marks the calling thread as compiling against a read-only engine
+ *
+ * While a ReadOnlyEngine exists, the calling thread may only read the
+ * state shared by the engine (types, namespaces, templates, values, ...).
+ * Operations that would modify it call check(), which throws
+ * DeferredCompilation; the function being compiled must then be compiled
+ * again once the engine is writable.
+ */
+class LIBSCRIPT_API ReadOnlyEngine
+{
+public:
+  ReadOnlyEngine();
+  ReadOnlyEngine(const ReadOnlyEngine &) = delete;
+  ~ReadOnlyEngine();
+
+  static bool isActive();
+  static void check();
+
+  ReadOnlyEngine & operator=(const ReadOnlyEngine &) = delete;
+
+private:
+  bool m_previous;
+};
+
+} // namespace compiler
+
+} // namespace script
+
+#endif // LIBSCRIPT_COMPILER_READONLYENGINE_H
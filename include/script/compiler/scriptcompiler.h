@@ -54,6 +54,7 @@ public:
   ~ScriptCompiler();
 
   void add(const Script & task);
+  bool reschedule(const Script & s, const std::shared_ptr<ast::FunctionDecl> & decl);
   Class instantiate(const ClassTemplate & ct, const std::vector<TemplateArgument> & args);
 
   bool done() const;
@@ -9,6 +9,7 @@
 
 #include "script/utils/stringview.h"
 
+#include <unordered_map>
 #include <vector>
 
 namespace script
@@ -31,6 +32,14 @@ struct Variable
   Variable(const Type & t, utils::StringView n, size_t i, bool g = false, bool s = false);
 };
 
+/*!
+ * \class Stack
+ * \brief the local variables of a function being compiled
+ *
+ * Variables are indexed by name so that looking up a name does not
+ * require scanning the stack.
+ * Variables must only be added and removed through addVar() and destroy().
+ */
 class Stack
 {
 public:
@@ -43,12 +52,13 @@ public:
   Stack(const Stack &) = delete;
 
   size_t size() const { return data.size(); }
-  void clear() { data.clear(); debuginfo = nullptr; }
+  void clear() { data.clear(); mNames.clear(); debuginfo = nullptr; }
 
   int addVar(const Type & t, utils::StringView name);
   int indexOf(const std::string & var) const;
   int lastIndexOf(const std::string & var) const;
   int lastIndexOf(utils::StringView var) const;
+  int lastIndexOf(utils::StringView var, size_t end) const;
   void destroy(size_t n);
 
   Stack & operator=(const Stack &) = delete;
@@ -56,6 +66,15 @@ public:
   const Variable& at(size_t i) const { return data.at(i); }
   Variable& operator[](size_t index) { return data[index]; }
   const Variable& operator[](size_t index) const { return data[index]; }
+
+private:
+  struct NameHash
+  {
+    size_t operator()(utils::StringView name) const;
+  };
+
+  // for each name, the indices of the variables with that name, in increasing order
+  std::unordered_map<utils::StringView, std::vector<size_t>, NameHash> mNames;
 };
 
 } // namespace compiler
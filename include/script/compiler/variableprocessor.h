@@ -71,6 +71,7 @@ protected:
   Value visit(const program::ConditionalExpression & ce);
   Value visit(const program::ConstructorCall & cc);
   Value visit(const program::Copy &);
+  Value visit(const program::EnumAssignment &);
   Value visit(const program::FetchGlobal &);
   Value visit(const program::FunctionCall & fc);
   Value visit(const program::FunctionVariableCall & fvc);
@@ -82,6 +83,7 @@ protected:
   Value visit(const program::LogicalOr &);
   Value visit(const program::MemberAccess & ma);
   Value visit(const program::StackValue &);
+  Value visit(const program::StringConcatenation & sc);
   Value visit(const program::VariableAccess &);
   Value visit(const program::VirtualCall &);
 };
@@ -205,9 +205,18 @@ public:
   Namespace rootNamespace() const;
 
   Script newScript(const SourceFile & source);
-  bool compile(Script s, CompileMode mode = CompileMode::Release);
+  bool compile(Script s, CompileMode mode = CompileMode::Release, RetentionPolicy policy = RetentionPolicy::KeepAll);
+  bool recompile(Script s, const SourceFile& src, CompileMode mode = CompileMode::Release);
   void destroy(Script s);
 
+  struct RetainedMemory
+  {
+    size_t source = 0;
+    size_t ast = 0;
+  };
+
+  RetainedMemory retainedMemory(const Script& s) const;
+
   Module newModule(const std::string & name);
   Module newModule(const std::string& name, ModuleLoadFunction load, ModuleCleanupFunction cleanup);
   Module newModule(std::string name, const SourceFile& src);
@@ -78,13 +78,13 @@ public:
   FunctionCall();
 
   FunctionCall * caller() const;
-  inline const Function & callee() const { return mCallee; }
+  inline const Function & callee() const { return *mCallee; }
 
   void setReturnValue(const Value & val);
   Value & returnValue();
   StackView args() const;
   Value arg(int index) const;
-  inline size_t argc() const { return callee().prototype().count(); }
+  inline size_t argc() const { return mArgc; }
 
   ThisObject thisObject() const;
 
@@ -99,7 +99,6 @@ public:
   void setContinueFlag();
   void clearFlags();
 
-  // this and the flags data member could be moved to the ExecutionContext class
   enum Flag {
     NoFlags = 0,
     BreakFlag = 1,
@@ -111,9 +110,11 @@ private:
   friend class Callstack;
   friend class ExecutionContext;
 private:
-  Function mCallee;
+  // the Function is owned by the caller (e.g. the program::FunctionCall 
+  // expression) and outlives the call, so there is no need for a copy
+  const Function *mCallee;
   size_t mStackIndex; // index of return value in the callstack
-  int flags;
+  size_t mArgc;
   ExecutionContext *ec;
 public:
   const program::Breakpoint* last_breakpoint = nullptr;
@@ -156,14 +157,18 @@ public:
   void push(const Function & f, size_t sp);
   Value pop();
 
-  int flags() const;
-  void clearFlags();
+  inline int flags() const { return mFlags; }
+  inline void clearFlags() { mFlags = FunctionCall::NoFlags; }
 
   Engine* engine;
   Callstack callstack;
   Stack stack;
   std::vector<Value> initializer_list_buffer;
   std::vector<Value> garbage_collector;
+
+private:
+  friend class FunctionCall;
+  int mFlags; // flags of the top-most FunctionCall
 };
 
 } // namespace interpreter
@@ -41,6 +41,7 @@ protected:
   Value inner_eval(const std::shared_ptr<program::Expression> & expr);
   Value manage(const Value & val);
   void invoke(const Function & f);
+  void compile_deferred(const Function & f);
 
 private:
   // StatementVisitor
@@ -71,6 +72,7 @@ private:
   Value visit(const program::ConditionalExpression &) override;
   Value visit(const program::ConstructorCall &) override;
   Value visit(const program::Copy &) override;
+  Value visit(const program::EnumAssignment &) override;
   Value visit(const program::FetchGlobal &) override;
   Value visit(const program::FunctionCall &) override;
   Value visit(const program::FunctionVariableCall &) override;
@@ -82,6 +84,7 @@ private:
   Value visit(const program::LogicalOr &) override;
   Value visit(const program::MemberAccess &) override;
   Value visit(const program::StackValue &) override;
+  Value visit(const program::StringConcatenation &) override;
   Value visit(const program::VariableAccess &) override;
   Value visit(const program::VirtualCall &) override;
 
@@ -0,0 +1,20 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBSCRIPT_MAP_TEMPLATE_H
+#define LIBSCRIPT_MAP_TEMPLATE_H
+
+#include "script/classtemplatenativebackend.h"
+
+namespace script
+{
+
+class LIBSCRIPT_API MapTemplate : public ClassTemplateNativeBackend
+{
+  Class instantiate(ClassTemplateInstanceBuilder& builder) override;
+};
+
+} // namespace script
+
+#endif // LIBSCRIPT_MAP_TEMPLATE_H
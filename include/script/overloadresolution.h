@@ -59,6 +59,16 @@ public:
   };
 
   static OverloadComparison compare(const Candidate& a, const Candidate& b);
+
+  struct CacheKey
+  {
+    std::vector<Function> candidates;
+    Type object;
+    std::vector<Type> types;
+  };
+
+  static bool findCachedResult(const CacheKey& key, Candidate& result);
+  static void cacheResult(CacheKey&& key, const Candidate& result);
 };
 
 
@@ -115,6 +125,30 @@ inline void overloadresolution_process_candidate(OverloadResolution::Candidate&
   }
 }
 
+template<typename T>
+bool overloadresolution_cache_key(OverloadResolution::CacheKey& key, const std::vector<Function>& candidates, const Type& object, const std::vector<T>& args)
+{
+  if (candidates.empty())
+    return false;
+
+  key.types.reserve(args.size());
+
+  for (const auto& a : args)
+  {
+    Type t = overload_resolution_helper<T>::get_type(a);
+
+    // the initialization of an initializer list depends on its elements
+    if (t.baseType() == Type::InitializerList)
+      return false;
+
+    key.types.push_back(t);
+  }
+
+  key.candidates = candidates;
+  key.object = object;
+  return true;
+}
+
 } // namespace details
 
 // @TODO: add an extra template parameter for diagnostics
@@ -126,6 +160,12 @@ OverloadResolution::Candidate resolve_overloads(const std::vector<Function>& can
   OverloadResolution::Candidate selected;
   OverloadResolution::Candidate ambiguous;
 
+  OverloadResolution::CacheKey key;
+  const bool cacheable = details::overloadresolution_cache_key(key, candidates, Type{}, args);
+
+  if (cacheable && OverloadResolution::findCachedResult(key, selected))
+    return selected;
+
   const size_t argc = args.size();
 
   for (const auto& func : candidates)
@@ -155,9 +195,13 @@ OverloadResolution::Candidate resolve_overloads(const std::vector<Function>& can
     details::overloadresolution_process_candidate(current, selected, ambiguous);
   }
 
-  if (ambiguous.function.isNull() && !selected.function.isNull())
-    return selected;
-  return {};
+  if (!ambiguous.function.isNull())
+    selected.reset();
+
+  if (cacheable)
+    OverloadResolution::cacheResult(std::move(key), selected);
+
+  return selected;
 }
 
 template<typename T, typename U>
@@ -170,6 +214,12 @@ OverloadResolution::Candidate resolve_overloads(const std::vector<Function>& can
   OverloadResolution::Candidate selected;
   OverloadResolution::Candidate ambiguous;
 
+  OverloadResolution::CacheKey key;
+  const bool cacheable = details::overloadresolution_cache_key(key, candidates, overload_resolution_helper<T>::get_type(implicit_object), args);
+
+  if (cacheable && OverloadResolution::findCachedResult(key, selected))
+    return selected;
+
   const int argc = static_cast<int>(args.size());
 
   for (const auto& func : candidates)
@@ -210,9 +260,13 @@ OverloadResolution::Candidate resolve_overloads(const std::vector<Function>& can
     details::overloadresolution_process_candidate(current, selected, ambiguous);
   }
 
-  if (ambiguous.function.isNull() && !selected.function.isNull())
-    return selected;
-  return {};
+  if (!ambiguous.function.isNull())
+    selected.reset();
+
+  if (cacheable)
+    OverloadResolution::cacheResult(std::move(key), selected);
+
+  return selected;
 }
 
 } // namespace script
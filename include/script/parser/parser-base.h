@@ -10,18 +10,36 @@
 #include "script/parser/parsererrors.h"
 #include "script/parser/token-reader.h"
 
+#include <exception>
+#include <map>
+
 namespace script
 {
 
 namespace parser
 {
 
+class TokenStream;
+
 struct LIBSCRIPT_API ParserContext
 {
+public:
+  /*!
+   * \struct Memo
+   * \brief result of a parse that was memoized
+   */
+  struct Memo
+  {
+    std::shared_ptr<ast::Node> node;
+    size_t end = 0;
+    std::exception_ptr error;
+  };
+
 private:
   const char* m_source;
   size_t m_size;
   std::vector<Token> m_tokens;
+  std::map<std::pair<size_t, size_t>, Memo> m_memos;
 public:
   explicit ParserContext(const char* src);
   explicit ParserContext(const std::string& str);
@@ -33,6 +51,11 @@ public:
   size_t source_length() const { return m_size; }
 
   const std::vector<Token>& tokens() const { return m_tokens; }
+
+  bool refill(TokenStream& stream);
+
+  const Memo* findMemo(size_t begin, size_t end) const;
+  void memoize(size_t begin, size_t end, Memo memo);
 };
 
 class LIBSCRIPT_API ParserBase : protected TokenReader
@@ -48,12 +48,14 @@ public:
   Parser();
   explicit Parser(const std::string& str);
   explicit Parser(const char* str);
+  Parser(const char* str, size_t size);
   ~Parser() = default;
 
   const std::vector<Token>& tokens() const;
 };
 
 LIBSCRIPT_API std::shared_ptr<ast::AST> parse(const SourceFile& source);
+LIBSCRIPT_API std::shared_ptr<ast::AST> parse(const SourceFile& source, size_t threads);
 
 LIBSCRIPT_API std::shared_ptr<ast::Expression> parseExpression(const std::string& src);
 LIBSCRIPT_API std::shared_ptr<ast::Expression> parseExpression(const char* src);
@@ -119,6 +119,9 @@ public:
   TemplateArgParser(std::shared_ptr<ParserContext> shared_context, const TokenReader& reader);
 
   std::shared_ptr<ast::Node> parse();
+
+protected:
+  std::shared_ptr<ast::Node> parseArgument();
 };
 
 class LIBSCRIPT_API TypeParser : public ParserBase
@@ -0,0 +1,59 @@
+// Copyright (C) 2018 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBSCRIPT_PARSING_TOKENSTREAM_H
+#define LIBSCRIPT_PARSING_TOKENSTREAM_H
+
+#include "script/parser/lexer.h"
+
+#include <vector>
+
+namespace script
+{
+
+namespace parser
+{
+
+/*!
+ * \class TokenStream
+ * \brief produces the tokens of a source one top-level statement at a time
+ *
+ * Unlike tokenize(), the TokenStream does not materialize the tokens of the 
+ * whole input; it reads them lazily from a Lexer with a lookahead of a single 
+ * token. 
+ * Memory usage is therefore proportional to the size of the largest top-level 
+ * statement rather than to the size of the input.
+ */
+class LIBSCRIPT_API TokenStream
+{
+public:
+  TokenStream(const char* src, size_t len);
+  TokenStream(const TokenStream&) = delete;
+  ~TokenStream() = default;
+
+  const char* source() const { return m_source; }
+  size_t source_length() const { return m_size; }
+
+  bool atEnd();
+
+  bool readStatement(std::vector<Token>& tokens);
+
+  TokenStream& operator=(const TokenStream&) = delete;
+
+protected:
+  const Token& peek();
+  Token read();
+
+private:
+  const char* m_source;
+  size_t m_size;
+  Lexer m_lexer;
+  Token m_lookahead;
+};
+
+} // namespace parser
+
+} // namespace script
+
+#endif // LIBSCRIPT_PARSING_TOKENSTREAM_H
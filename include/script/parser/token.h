@@ -9,6 +9,8 @@
 
 #include "script/utils/stringview.h"
 
+#include <cstdint>
+
 namespace script
 {
 
@@ -17,12 +19,22 @@ namespace parser
 
 using utils::StringView;
 
+/*!
+ * \class Token
+ * \brief a token produced by the lexer
+ *
+ * The layout of this class is kept compact (16 bytes on 64-bit platforms) 
+ * as tokens are stored in large arrays by the parser and copied into the 
+ * nodes of the AST.
+ */
 class Token
 {
 public:
   Token()
-    : id(Token::Invalid)
-    , flags(0)
+    : m_data(""),
+      m_size(0),
+      id(Token::Invalid),
+      flags(0)
   {
 
   }
@@ -32,14 +44,14 @@ public:
 
 
   enum Kind {
-    Punctuator = 0x010000,
-    Literal    = 0x020000,
-    OperatorToken   = 0x040000,
-    Identifier = 0x080000,
-    Keyword    = 0x100000 | Identifier,
+    Punctuator = 0x01,
+    Literal    = 0x02,
+    OperatorToken   = 0x04,
+    Identifier = 0x08,
+    Keyword    = 0x10 | Identifier,
   };
 
-  enum Id {
+  enum Id : uint16_t {
     Invalid,
     /* Literals */
     IntegerLiteral,
@@ -164,17 +176,21 @@ public:
 
   // @TODO: add a constructor that computes the 'flags' automatically using a built-in table
   Token(Id t, int flags_, StringView str)
-    : id(t)
-    , flags(flags_)
-    , m_text(str)
+    : m_data(str.data()),
+      m_size(static_cast<uint32_t>(str.size())),
+      id(t),
+      flags(static_cast<uint16_t>(flags_))
   {
 
   }
 
+private:
+  const char* m_data;
+  uint32_t m_size;
 
+public:
   Id id;
-  int flags;
-  StringView m_text;
+  uint16_t flags;
 
   bool isValid() const { return id != Invalid; }
 
@@ -183,9 +199,9 @@ public:
   bool isKeyword() const { return flags & Keyword; }
   bool isLiteral() const { return flags & Literal; }
 
-  bool isZero() const { return id == OctalLiteral && m_text.size() == 1; }
+  bool isZero() const { return id == OctalLiteral && m_size == 1; }
 
-  StringView text() const { return m_text; }
+  StringView text() const { return StringView(m_data, m_size); }
   std::string toString() const { return text().toString(); }
 
   Token & operator=(const Token &) = default;
@@ -6,6 +6,7 @@
 #define LIBSCRIPT_CLASS_P_H
 
 #include "script/private/symbol_p.h"
+#include "script/private/symboltable_p.h"
 
 #include "script/cast.h"
 #include "script/class.h"
@@ -52,6 +53,7 @@ public:
   std::shared_ptr<UserData> data;
   std::vector<Function> friend_functions;
   std::vector<Class> friend_classes;
+  mutable SymbolTable symbols;
 
   ClassImpl(int i, const std::string & n, Engine *e)
     : SymbolImpl(e)
@@ -19,6 +19,8 @@
 
 #include "script/interpreter/interpreter.h"
 
+#include "script/private/overloadresolution_p.h"
+
 namespace script
 {
 
@@ -51,9 +53,12 @@ public:
   {
     ClassTemplate array;
     ClassTemplate initializer_list;
+    ClassTemplate map;
     std::map<std::type_index, Template> dict;
   }templates;
 
+  OverloadResolutionCache overload_resolution_cache;
+
 public:
   /// TODO: move elsewhere, perhaps a namespace 'optimisation'
   Value default_construct(const Type & t, const Function & ctor);
@@ -62,6 +67,7 @@ public:
 
   void destroy(Namespace ns);
   void destroy(Script s);
+  void reset(Script s);
 };
 
 
@@ -21,6 +21,9 @@ public:
   int id;
   std::string name;
   bool enumClass;
+  // true if the enum uses the default callbacks; its values are then 
+  // EnumeratorValue and are copied and assigned without invoking a function
+  bool intrinsic;
   std::map<std::string, int> values;
   // @TODO: replace by virtual functions
   // virtual script::Value from_int(int n);
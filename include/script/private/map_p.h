@@ -0,0 +1,94 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBSCRIPT_MAP_P_H
+#define LIBSCRIPT_MAP_P_H
+
+#include "script/types.h"
+#include "script/function.h"
+#include "script/userdata.h"
+#include "script/value.h"
+
+#include <vector>
+
+namespace script
+{
+
+class ClassTemplate;
+
+struct MapData
+{
+  Type typeId;
+  Type keyType;
+  Type valueType;
+  Function keyCopyConstructor;
+  Function keyDestructor;
+  Function valueConstructor;
+  Function valueCopyConstructor;
+  Function valueDestructor;
+  Function hash; // int K::hash() const, for class keys
+  Function equal; // bool operator==(const K&, const K&), for class keys
+};
+
+class SharedMapData : public UserData
+{
+public:
+  SharedMapData(const MapData & d);
+  ~SharedMapData() = default;
+  MapData data;
+};
+
+/*!
+ * \class MapImpl
+ * \brief hash table backing the Map<K, V> class template
+ *
+ * Entries are stored contiguously and looked up using open addressing 
+ * with linear probing; removal uses backward-shift deletion so that 
+ * no tombstones are needed.
+ * The capacity is always a power of two.
+ */
+class LIBSCRIPT_API MapImpl
+{
+public:
+  struct Slot
+  {
+    Value key;
+    Value value;
+    size_t hash = 0;
+    bool used = false;
+  };
+
+public:
+  MapImpl(const std::shared_ptr<SharedMapData> & d, Engine *e);
+  MapImpl(const MapImpl & other);
+  ~MapImpl() = default;
+
+  inline const MapData & data() const { return shared_data->data; }
+
+  size_t hash(const Value & key) const;
+  bool equal(const Value & a, const Value & b) const;
+
+  Slot* find(const Value & key);
+  Value& get(const Value & key);
+  bool insert(const Value & key, const Value & value);
+  bool remove(const Value & key);
+  void reserve(size_t n);
+  void clear();
+  void assign(const MapImpl & other);
+
+  static ClassTemplate register_map_template(Engine *e);
+
+  std::shared_ptr<SharedMapData> shared_data;
+  Engine *engine;
+  std::vector<Slot> slots;
+  size_t size;
+
+protected:
+  size_t probe(const Value & key, size_t h) const;
+  void rehash(size_t capacity);
+};
+
+} // namespace script
+
+#endif // LIBSCRIPT_MAP_P_H
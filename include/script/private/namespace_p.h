@@ -6,6 +6,7 @@
 #define LIBSCRIPT_NAMESPACE_P_H
 
 #include "script/private/symbol_p.h"
+#include "script/private/symboltable_p.h"
 
 #include "script/enum.h"
 #include "script/class.h"
@@ -38,6 +39,7 @@ public:
   std::vector<Template> templates;
   std::vector<Typedef> typedefs;
   std::weak_ptr<ModuleInterface> the_module;
+  mutable SymbolTable symbols;
 
 public:
   NamespaceImpl(const std::string & n, Engine *e)
@@ -0,0 +1,76 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBSCRIPT_OVERLOADRESOLUTION_P_H
+#define LIBSCRIPT_OVERLOADRESOLUTION_P_H
+
+#include "script/overloadresolution.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace script
+{
+
+/*!
+ * \class OverloadResolutionCache
+ * \brief stores the result of overload resolutions of an engine
+ *
+ * Results are keyed by the list of candidates, the type of the implicit
+ * object and the types of the arguments.
+ * Adding a constructor, a conversion function or an operator may change 
+ * how arguments convert to parameters, so the whole cache is invalidated 
+ * when such a function is added.
+ * Adding any other function only invalidates the cache if its name is the 
+ * name of a cached candidate.
+ */
+class OverloadResolutionCache
+{
+public:
+  OverloadResolutionCache() = default;
+  OverloadResolutionCache(const OverloadResolutionCache&) = delete;
+  ~OverloadResolutionCache() = default;
+
+  bool find(const OverloadResolution::CacheKey& key, OverloadResolution::Candidate& result);
+  void insert(OverloadResolution::CacheKey&& key, const OverloadResolution::Candidate& result);
+
+  void invalidate();
+  void invalidate(const Function& f);
+
+  size_t size() const;
+
+  static const size_t MaxSize = 16384;
+
+private:
+  struct Hash
+  {
+    size_t operator()(const OverloadResolution::CacheKey& key) const;
+  };
+
+  struct Equal
+  {
+    bool operator()(const OverloadResolution::CacheKey& a, const OverloadResolution::CacheKey& b) const;
+  };
+
+  struct Entry
+  {
+    Function function;
+    std::vector<Initialization> initializations;
+  };
+
+  void check_validity();
+
+private:
+  mutable std::mutex m_mutex;
+  std::atomic<bool> m_invalidated{ false };
+  std::unordered_map<OverloadResolution::CacheKey, Entry, Hash, Equal> m_entries;
+  std::unordered_set<std::string> m_names;
+};
+
+} // namespace script
+
+#endif // LIBSCRIPT_OVERLOADRESOLUTION_P_H
@@ -17,9 +17,23 @@
 #include "script/script.h"
 #include "script/typedefs.h"
 
+#include "script/private/symboltable_p.h"
+
+#include <mutex>
+
 namespace script
 {
 
+/*!
+ * \class ScopeImpl
+ * \brief node of a chain of scopes
+ *
+ * Chains of scopes are persistent: a copy of a node shares its parent, 
+ * and its data, with the original node.
+ * A node that is shared must therefore be copied before being modified; 
+ * modifying a node deeper in the chain requires copying the nodes 
+ * that lead to it.
+ */
 class ScopeImpl
 {
 public:
@@ -57,6 +71,8 @@ public:
   virtual const std::map<std::string, Value> & values() const;
   virtual const std::vector<Typedef> & typedefs() const;
 
+  virtual SymbolTable* symbols() const;
+
   virtual bool lookup(const std::string & name, NameLookupImpl *nl) const;
 
   virtual void invalidate_cache(int which);
@@ -69,13 +85,20 @@ public:
   ExtensibleScope(const ExtensibleScope & other);
   ~ExtensibleScope() = default;
 
-  std::map<std::string, Type> type_aliases;
+  struct Injections
+  {
+    std::map<std::string, Type> type_aliases;
+    std::vector<Class> classes;
+    std::vector<Enum> enums;
+    std::vector<Function> functions;
+    std::map<std::string, Value> values;
+    std::vector<Typedef> typedefs;
+    mutable SymbolTable symbols;
+  };
+
+  std::shared_ptr<Injections> injections; // shared between copies of the scope, may be null
 
-  std::vector<Class> injected_classes;
-  std::vector<Enum> injected_enums;
-  std::vector<Function> injected_functions;
-  std::map<std::string, Value> injected_values;
-  std::vector<Typedef> injected_typedefs;
+  Injections & injections_for_write();
 
   bool lookup(const std::string & name, NameLookupImpl *nl) const override;
 };
@@ -87,9 +110,29 @@ public:
   NamespaceScope(const NamespaceScope & other);
   ~NamespaceScope() = default;
 
+  struct Imports
+  {
+    Imports() = default;
+    Imports(const Imports & other);
+
+    std::vector<Namespace> namespaces;
+    std::map<std::string, NamespaceAlias> aliases;
+
+    // symbols of the namespace and of the imported namespaces, filled on first use
+    mutable std::vector<Class> classes;
+    mutable std::vector<Enum> enums;
+    mutable std::vector<Function> functions;
+    mutable std::vector<LiteralOperator> literal_operators;
+    mutable std::vector<Operator> operators;
+    mutable std::vector<Template> templates;
+    mutable std::map<std::string, Value> values;
+    mutable std::vector<Typedef> typedefs;
+    mutable SymbolTable symbols;
+    mutable std::mutex mutex; // guards the caches above, which may be filled by several threads
+  };
+
   Namespace mNamespace;
-  std::vector<Namespace> mImportedNamespaces;
-  std::map<std::string, NamespaceAlias> mNamespaceAliases;
+  std::shared_ptr<Imports> mImports; // shared between copies of the scope, may be null
 
   Engine * engine() const override;
   int kind() const override;
@@ -103,14 +146,8 @@ public:
 
   bool has_child(const std::string & name) const;
 
-  mutable std::vector<Class> mClasses;
-  mutable std::vector<Enum> mEnums;
-  mutable std::vector<Function> mFunctions;
-  mutable std::vector<LiteralOperator> mLiteralOperators;
-  mutable std::vector<Operator> mOperators;
-  mutable std::vector<Template> mTemplates;
-  mutable std::map<std::string, Value> mValues;
-  mutable std::vector<Typedef> mTypedefs;
+  const std::vector<Namespace> & imported_namespaces() const;
+  Imports & imports_for_write();
 
   const std::vector<Class> & classes() const override;
   const std::vector<Enum> & enums() const override;
@@ -122,6 +159,8 @@ public:
   const std::map<std::string, Value> & values() const override;
   const std::vector<Typedef> & typedefs() const override;
 
+  SymbolTable* symbols() const override;
+
   void import_namespace(const NamespaceScope & other);
 
   bool lookup(const std::string & name, NameLookupImpl *nl) const override;
@@ -152,6 +191,8 @@ public:
   const std::vector<Template> & templates() const override;
   const std::vector<Typedef> & typedefs() const override;
 
+  SymbolTable* symbols() const override;
+
   bool lookup(const std::string & name, NameLookupImpl *nl) const override;
 
   static bool lookup(const std::string & name, const Class & c, NameLookupImpl *nl);
@@ -6,6 +6,7 @@
 #define LIBSCRIPT_SCRIPT_P_H
 
 #include "script/attributes-map.h"
+#include "script/compilemode.h"
 #include "script/defaultargumentsmap.h"
 #include "script/namespace.h"
 #include "script/private/namespace_p.h"
@@ -13,11 +14,16 @@
 #include "script/sourcefile.h"
 #include "script/diagnosticmessage.h"
 
+#include "script/compiler/compilefunctiontask.h"
+
+#include <unordered_map>
+
 namespace script
 {
 
 namespace ast
 {
+class Arena;
 class AST;
 } // namespace ast
 
@@ -46,15 +52,27 @@ public:
   std::vector<diagnostic::DiagnosticMessage> messages;
   bool astlock;
   std::shared_ptr<ast::AST> ast;
+  std::weak_ptr<ast::Arena> ast_arena; // may outlive the ast
   Scope exports;
+  std::shared_ptr<ast::Arena> attributes_arena; // storage of the attributes, which outlive the ast
+  SourceFile attributes_source; // the tokens of the attributes reference its content
   AttributesMap attributes;
   DefaultArgumentsMap defaultarguments;
   FunctionCreator* function_creator = nullptr;
 
   std::map<std::shared_ptr<FunctionImpl>, std::vector<std::shared_ptr<program::Breakpoint>>> breakpoints_map;
 
+  // functions whose compilation is deferred until they are first called
+  std::vector<compiler::CompileFunctionTask> deferred_functions;
+  std::unordered_map<const FunctionImpl*, size_t> deferred_functions_index;
+  std::unordered_map<const FunctionImpl*, diagnostic::DiagnosticMessage> failed_functions; // deferred functions that failed to compile, with their first error
+  RetentionPolicy deferred_retention = RetentionPolicy::KeepAll; // applied once no function is deferred anymore
+
   void register_global(const Type& t, std::string name);
   void add_breakpoint(script::Function f, std::shared_ptr<program::Breakpoint> bp);
+
+  bool ast_locked() const;
+  void apply_retention_policy(RetentionPolicy policy);
 };
 
 } // namespace script
@@ -7,18 +7,30 @@
 
 #include "libscriptdefs.h"
 
+#include <string>
+#include <vector>
+
 namespace script {
 
 struct SourceFileImpl
 {
   std::string filepath;
   std::string content;
+  const char* mapping; // non-null if the file is memory-mapped
+  size_t mapping_size;
   bool open;
   bool lock;
+  std::vector<size_t> line_offsets; // offset of the beginning of each line, computed on demand
 
 public:
   SourceFileImpl(const std::string & path);
-  ~SourceFileImpl() = default;
+  ~SourceFileImpl();
+
+  bool map();
+  void unmap();
+  void copy_mapping();
+
+  const std::vector<size_t>& lines(const char* data, size_t size);
 };
 
 } // namespace script
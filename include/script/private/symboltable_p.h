@@ -0,0 +1,86 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBSCRIPT_SYMBOLTABLE_P_H
+#define LIBSCRIPT_SYMBOLTABLE_P_H
+
+#include "script/class.h"
+#include "script/enum.h"
+#include "script/function.h"
+#include "script/operator.h"
+#include "script/template.h"
+#include "script/typedefs.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace script
+{
+
+/*!
+ * \class SymbolTable
+ * \brief name-keyed index over the symbol lists of a namespace, a class or a scope
+ *
+ * The table does not own the symbols, it stores their positions in the
+ * lists it is synchronized with.
+ * Symbol lists only grow between two clear(), so sync() indexes the
+ * symbols that were appended since the last call.
+ *
+ * Operators are indexed separately, by OperatorName and, for operators
+ * taking two fundamental types, by the pair of operand types.
+ *
+ * sync() may be called by several threads at once, provided that the
+ * lists are not modified meanwhile.
+ */
+class SymbolTable
+{
+public:
+  SymbolTable() = default;
+  SymbolTable(const SymbolTable & other);
+  ~SymbolTable() = default;
+
+  struct Entry
+  {
+    std::vector<size_t> enums;
+    std::vector<size_t> classes;
+    std::vector<size_t> typedefs;
+    std::vector<size_t> functions;
+    std::vector<size_t> templates;
+  };
+
+  void sync(const std::vector<Enum> & enums, const std::vector<Class> & classes, const std::vector<Typedef> & typedefs,
+    const std::vector<Function> & functions, const std::vector<Template> & templates);
+
+  const Entry* find(const std::string & name) const;
+
+  void sync(const std::vector<Operator> & operators);
+
+  const std::vector<size_t> & operators(OperatorName op) const;
+  const std::vector<size_t> & operators(OperatorName op, const Type & lhs, const Type & rhs) const;
+
+  void clear();
+
+  SymbolTable & operator=(const SymbolTable & other);
+
+private:
+  void reset();
+
+private:
+  mutable std::mutex m_mutex;
+  std::unordered_map<std::string, Entry> m_entries;
+  size_t m_enums = 0;
+  size_t m_classes = 0;
+  size_t m_typedefs = 0;
+  size_t m_functions = 0;
+  size_t m_templates = 0;
+  std::vector<std::vector<size_t>> m_operators;
+  std::unordered_map<uint64_t, std::vector<size_t>> m_fundamental_operators;
+  size_t m_operator_count = 0;
+};
+
+} // namespace script
+
+#endif // LIBSCRIPT_SYMBOLTABLE_P_H
@@ -16,7 +16,10 @@
 
 #include "script/private/symbol_p.h"
 
+#include <algorithm>
+#include <array>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace script
@@ -24,6 +27,141 @@ namespace script
 
 class SymbolImpl;
 
+/*!
+ * \class TemplateInstanceTable
+ * \brief stores the instances of a template
+ *
+ * Instances are kept in a map ordered by their template arguments, 
+ * which is exposed by ClassTemplate::instances() and FunctionTemplate::instances().
+ * Lookups go through a hash index of the arguments and, for templates 
+ * with a single type argument such as Array<T>, through a small table 
+ * indexed by the type.
+ */
+template<typename T>
+class TemplateInstanceTable
+{
+public:
+  typedef std::map<std::vector<TemplateArgument>, T, TemplateArgumentComparison> map_type;
+
+  TemplateInstanceTable()
+  {
+    m_direct.fill(m_instances.end());
+  }
+
+  TemplateInstanceTable(const TemplateInstanceTable&) = delete;
+
+  const map_type& map() const { return m_instances; }
+
+  size_t size() const { return m_instances.size(); }
+  bool empty() const { return m_instances.empty(); }
+
+  bool find(const std::vector<TemplateArgument>& args, T* value) const
+  {
+    typename map_type::const_iterator it;
+
+    if (find_direct(args, it) || find_indexed(args, it))
+    {
+      if (value != nullptr)
+        *value = it->second;
+
+      return true;
+    }
+
+    return false;
+  }
+
+  void insert(const std::vector<TemplateArgument>& args, const T& value)
+  {
+    typename map_type::iterator it = m_instances.find(args);
+
+    if (it != m_instances.end())
+    {
+      it->second = value;
+      return;
+    }
+
+    it = m_instances.emplace(args, value).first;
+    m_index.emplace(TemplateArgumentHash()(args), it);
+
+    if (is_direct(args))
+      m_direct[slot(args.front().type)] = it;
+  }
+
+  void erase(const std::vector<TemplateArgument>& args)
+  {
+    typename map_type::iterator it = m_instances.find(args);
+
+    if (it == m_instances.end())
+      return;
+
+    auto range = m_index.equal_range(TemplateArgumentHash()(args));
+    for (auto entry = range.first; entry != range.second; ++entry)
+    {
+      if (entry->second == it)
+      {
+        m_index.erase(entry);
+        break;
+      }
+    }
+
+    for (auto& d : m_direct)
+    {
+      if (d == it)
+        d = m_instances.end();
+    }
+
+    m_instances.erase(it);
+  }
+
+protected:
+  static bool is_direct(const std::vector<TemplateArgument>& args)
+  {
+    return args.size() == 1 && args.front().kind == TemplateArgument::TypeArgument;
+  }
+
+  static size_t slot(const Type& t)
+  {
+    const size_t n = static_cast<size_t>(t.data());
+    return (n ^ (n >> 16)) % DirectSlots;
+  }
+
+  bool find_direct(const std::vector<TemplateArgument>& args, typename map_type::const_iterator& result) const
+  {
+    if (!is_direct(args))
+      return false;
+
+    typename map_type::const_iterator it = m_direct[slot(args.front().type)];
+
+    if (it == m_instances.end() || it->first.front().type.data() != args.front().type.data())
+      return false;
+
+    result = it;
+    return true;
+  }
+
+  bool find_indexed(const std::vector<TemplateArgument>& args, typename map_type::const_iterator& result) const
+  {
+    auto range = m_index.equal_range(TemplateArgumentHash()(args));
+    for (auto entry = range.first; entry != range.second; ++entry)
+    {
+      if (entry->second->first.size() == args.size() && std::equal(args.begin(), args.end(), entry->second->first.begin()))
+      {
+        result = entry->second;
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+private:
+  static const size_t DirectSlots = 8;
+
+  map_type m_instances;
+  std::unordered_multimap<size_t, typename map_type::iterator> m_index;
+  std::array<typename map_type::iterator, DirectSlots> m_direct;
+};
+
 class TemplateImpl : public SymbolImpl
 {
 public:
@@ -33,6 +171,7 @@ public:
   SymbolKind get_kind() const override;
   virtual const std::string& name() const = 0;
 
+  std::shared_ptr<ast::Arena> arena; // storage of the ast nodes of a script template
   std::vector<TemplateParameter> parameters;
   Scope scope;
 
@@ -47,7 +186,7 @@ public:
   ~FunctionTemplateImpl();
 
   std::string function_name;
-  std::map<std::vector<TemplateArgument>, Function, TemplateArgumentComparison> instances;
+  TemplateInstanceTable<Function> instances;
   std::unique_ptr<FunctionTemplateNativeBackend> backend;
 
   const std::string& name() const override;
@@ -61,7 +200,7 @@ public:
   ~ClassTemplateImpl();
 
   std::string class_name;
-  std::map<std::vector<TemplateArgument>, Class, TemplateArgumentComparison> instances;
+  TemplateInstanceTable<Class> instances;
   std::unique_ptr<ClassTemplateNativeBackend> backend;
 
   const std::string& name() const override;
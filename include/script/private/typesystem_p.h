@@ -7,12 +7,15 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <typeindex>
+#include <unordered_map>
 #include <vector>
 
 #include "script/enum.h"
 #include "script/class.h"
 #include "script/classtemplate.h"
+#include "script/conversions.h"
 #include "script/functiontype.h"
 #include "script/context.h"
 #include "script/module.h"
@@ -28,6 +31,43 @@ namespace script
 class Engine;
 class TypeSystemTransaction;
 
+/*!
+ * \class ConversionCache
+ * \brief memoizes the conversions involving class types
+ *
+ * Conversions between classes depend on their inheritance, constructors
+ * and conversion functions. The cache is cleared whenever a constructor, 
+ * a conversion function or a base class is added; the conversions 
+ * involving a type are removed when the type is destroyed.
+ */
+class ConversionCache : public TypeSystemListener
+{
+public:
+  ConversionCache() = default;
+  ~ConversionCache() = default;
+
+  bool find(const Type& src, const Type& dest, int policy, Conversion& result) const;
+  void insert(const Type& src, const Type& dest, int policy, const Conversion& result);
+
+  bool find(const Type& src, const Type& dest, StandardConversion& result) const;
+  void insert(const Type& src, const Type& dest, const StandardConversion& result);
+
+  void clear();
+
+  size_t size() const;
+
+  void created(const Type& t) override;
+  void destroyed(const Type& t) override;
+
+private:
+  static uint64_t key(const Type& src, const Type& dest);
+
+private:
+  mutable std::mutex m_mutex;
+  std::unordered_map<uint64_t, Conversion> m_conversions[2];
+  std::unordered_map<uint64_t, StandardConversion> m_standard_conversions;
+};
+
 class TypeSystemImpl
 {
 public:
@@ -55,6 +95,8 @@ public:
 
   std::vector<std::unique_ptr<TypeSystemListener>> listeners;
 
+  ConversionCache conversions;
+
   TypeSystemTransaction* active_transaction = nullptr;
 
 public:
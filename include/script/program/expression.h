@@ -226,6 +226,24 @@ public:
   Value accept(ExpressionVisitor &) override;
 };
 
+// assigns an enumerator without calling the enumeration's assignment operator
+struct LIBSCRIPT_API EnumAssignment : public Expression
+{
+  Type value_type;
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+
+public:
+  EnumAssignment(const Type & t, const std::shared_ptr<Expression> & l, const std::shared_ptr<Expression> & r);
+  ~EnumAssignment() = default;
+
+  Type type() const override;
+
+  static std::shared_ptr<EnumAssignment> New(const Type & t, const std::shared_ptr<Expression> & l, const std::shared_ptr<Expression> & r);
+
+  Value accept(ExpressionVisitor &) override;
+};
+
 struct LIBSCRIPT_API FundamentalConversion : public Expression
 {
   Type dest_type;
@@ -378,6 +396,22 @@ public:
   Value accept(ExpressionVisitor &) override;
 };
 
+// concatenates a chain of Strings in a single pass
+class LIBSCRIPT_API StringConcatenation : public Expression
+{
+public:
+  std::vector<std::shared_ptr<Expression>> operands;
+
+  StringConcatenation(std::vector<std::shared_ptr<Expression>> && ops);
+  ~StringConcatenation() = default;
+
+  Type type() const override;
+
+  static std::shared_ptr<StringConcatenation> New(std::vector<std::shared_ptr<Expression>> && ops);
+
+  Value accept(ExpressionVisitor &) override;
+};
+
 class LIBSCRIPT_API ExpressionVisitor
 {
 public:
@@ -391,6 +425,7 @@ public:
   virtual Value visit(const ConditionalExpression &) = 0;
   virtual Value visit(const ConstructorCall &) = 0;
   virtual Value visit(const Copy &) = 0;
+  virtual Value visit(const EnumAssignment &) = 0;
   virtual Value visit(const FetchGlobal &) = 0;
   virtual Value visit(const FunctionCall &) = 0;
   virtual Value visit(const FunctionVariableCall &) = 0;
@@ -402,6 +437,7 @@ public:
   virtual Value visit(const LogicalOr &) = 0;
   virtual Value visit(const MemberAccess &) = 0;
   virtual Value visit(const StackValue &) = 0;
+  virtual Value visit(const StringConcatenation &) = 0;
   virtual Value visit(const VariableAccess &) = 0;
   virtual Value visit(const VirtualCall &) = 0;
 };
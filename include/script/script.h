@@ -49,9 +49,10 @@ public:
   int id() const;
 
   void attach(FunctionCreator& fcreator);
-  bool compile(CompileMode mode = CompileMode::Release, FunctionCreator* fcreator = nullptr);
+  bool compile(CompileMode mode = CompileMode::Release, FunctionCreator* fcreator = nullptr, RetentionPolicy policy = RetentionPolicy::KeepAll);
   bool isReady() const;
   bool isCompiled() const;
+  bool compileAll();
   void run();
 
   void clear();
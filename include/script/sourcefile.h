@@ -23,7 +23,8 @@ struct SourceFileImpl;
  * and thus uses a \t{std::string} as the underlying storage type.
  *
  * If the input is a local file, it is not loaded until \m load is called.
- * After a call to \m load, the entire file is stored in memory.
+ * After a call to \m load, the entire file is available in memory; 
+ * when possible, the file is memory-mapped rather than read.
  * Memory can be released by calling \m unload unless the source file
  * \m isLocked, meaning that the system needs the source to be available
  * (this is the case, for example, if your script contains templates).
@@ -80,6 +81,7 @@ public:
   void unload();
 
   const char* data() const;
+  size_t size() const;
   const std::string& content() const;
 
   static SourceFile fromString(const std::string& src);
@@ -51,10 +51,57 @@ public:
    * \brief Callbacks used by the engine to fill the string type.
    */
   static void register_string_type(Class& string);
+
+  /*!
+   * \fn static void register_string_builder_type(Class& builder)
+   * \brief Callbacks used by the engine to fill the StringBuilder type.
+   */
+  static void register_string_builder_type(Class& builder);
+
+  /*!
+   * \fn static void register_string_view_type(Class& view)
+   * \brief Callbacks used by the engine to fill the StringView type.
+   */
+  static void register_string_view_type(Class& view);
 };
 
 using String = StringBackend::string_type;
 
+/*!
+ * \class StringBuilder
+ * \brief Accumulates strings into a single growing buffer
+ *
+ * This class backs the StringBuilder type exposed in the scripting language.
+ * Appending to a StringBuilder is amortized constant time, which makes it 
+ * the preferred way of building a long String out of many small pieces.
+ */
+
+class LIBSCRIPT_API StringBuilder
+{
+public:
+  StringBuilder() = default;
+  StringBuilder(const StringBuilder&) = default;
+  StringBuilder(StringBuilder&&) = default;
+  ~StringBuilder() = default;
+
+  StringBuilder& append(const String& str) { m_buffer.append(str); return *this; }
+  StringBuilder& append(char c) { m_buffer.push_back(c); return *this; }
+
+  void reserve(size_t n) { m_buffer.reserve(n); }
+  size_t capacity() const { return m_buffer.capacity(); }
+  size_t size() const { return m_buffer.size(); }
+  void clear() { m_buffer.clear(); }
+
+  const String& toString() const { return m_buffer; }
+  String release() { String ret{ std::move(m_buffer) }; m_buffer.clear(); return ret; }
+
+  StringBuilder& operator=(const StringBuilder&) = default;
+  StringBuilder& operator=(StringBuilder&&) = default;
+
+private:
+  String m_buffer;
+};
+
 } // namespace script
 
 #endif // LIBSCRIPT_STRING_H
@@ -0,0 +1,69 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBSCRIPT_SCRIPT_STRINGVIEW_H
+#define LIBSCRIPT_SCRIPT_STRINGVIEW_H
+
+#include "script/value.h"
+
+#include "script/utils/stringview.h"
+
+#include <vector>
+
+namespace script
+{
+
+/*!
+ * \class StringView
+ * \brief A non-owning view on a range of characters of a String
+ *
+ * This class backs the StringView type exposed in the scripting language.
+ * A StringView keeps a reference on the \t Value holding the viewed String,
+ * so that the String stays alive as long as views on it exist.
+ * The range is stored as an offset and a length, and is clamped to the
+ * current size of the String when accessed; modifying the source String
+ * therefore never results in a dangling view.
+ */
+
+class LIBSCRIPT_API StringView
+{
+public:
+  StringView();
+  StringView(const StringView&) = default;
+  ~StringView() = default;
+
+  explicit StringView(const Value& str);
+  StringView(const Value& str, size_t pos, size_t count);
+
+  static const size_t npos = static_cast<size_t>(-1);
+
+  const Value& source() const { return m_source; }
+  size_t offset() const { return m_offset; }
+
+  utils::StringView view() const;
+
+  size_t size() const { return view().size(); }
+  bool empty() const { return size() == 0; }
+  char at(size_t index) const;
+
+  size_t find(const utils::StringView& str, size_t pos = 0) const;
+  StringView substr(size_t pos, size_t count = npos) const;
+  int compare(const utils::StringView& other) const;
+  bool starts_with(const utils::StringView& str) const;
+  bool ends_with(const utils::StringView& str) const;
+  std::vector<StringView> split(char sep) const;
+
+  String toString() const { return view().toString(); }
+
+  StringView& operator=(const StringView&) = default;
+
+private:
+  Value m_source;
+  size_t m_offset;
+  size_t m_size;
+};
+
+} // namespace script
+
+#endif // LIBSCRIPT_SCRIPT_STRINGVIEW_H
@@ -78,6 +78,13 @@ struct TemplateArgumentComparison
   bool operator()(const std::vector<TemplateArgument> & a, const std::vector<TemplateArgument> & b) const;
 };
 
+// hashes template arguments consistently with TemplateArgumentComparison
+struct LIBSCRIPT_API TemplateArgumentHash
+{
+  size_t operator()(const TemplateArgument & arg) const;
+  size_t operator()(const std::vector<TemplateArgument> & args) const;
+};
+
 } // namespace script
 
 #endif // LIBSCRIPT_TEMPLATE_ARGUMENT_H
@@ -0,0 +1,125 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "script/ast/arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace script
+{
+
+namespace ast
+{
+
+static const size_t arena_block_size = 64 * 1024;
+
+static thread_local std::shared_ptr<Arena> current_arena;
+
+Arena::Arena()
+  : m_ptr(nullptr)
+  , m_end(nullptr)
+  , m_allocated(0)
+  , m_reserved(0)
+{
+
+}
+
+Arena::~Arena()
+{
+
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+  uintptr_t p = (reinterpret_cast<uintptr_t>(m_ptr) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+
+  if (m_ptr == nullptr || p + size > reinterpret_cast<uintptr_t>(m_end))
+  {
+    const size_t block_size = std::max(arena_block_size, size + alignment);
+    m_blocks.emplace_back(new char[block_size]);
+    m_ptr = m_blocks.back().get();
+    m_end = m_ptr + block_size;
+    m_reserved += block_size;
+
+    p = (reinterpret_cast<uintptr_t>(m_ptr) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+  }
+
+  m_ptr = reinterpret_cast<char*>(p + size);
+  m_allocated += size;
+
+  return reinterpret_cast<void*>(p);
+}
+
+/*!
+ * \fn void adopt(std::shared_ptr<Arena> other)
+ * \param other arena
+ * \brief keeps another arena alive for as long as this one
+ *
+ * This is used when the nodes of a single AST were allocated from several 
+ * arenas (e.g. when parsing on several threads); the memory of the adopted
+ * arenas is accounted for by bytesAllocated() and bytesReserved().
+ */
+void Arena::adopt(std::shared_ptr<Arena> other)
+{
+  m_adopted.push_back(std::move(other));
+}
+
+/*!
+ * \fn size_t bytesAllocated() const
+ * \brief returns the number of bytes handed out by the arena
+ */
+size_t Arena::bytesAllocated() const
+{
+  size_t result = m_allocated;
+
+  for (const auto& a : m_adopted)
+    result += a->bytesAllocated();
+
+  return result;
+}
+
+/*!
+ * \fn size_t bytesReserved() const
+ * \brief returns the number of bytes obtained from the system
+ */
+size_t Arena::bytesReserved() const
+{
+  size_t result = m_reserved;
+
+  for (const auto& a : m_adopted)
+    result += a->bytesReserved();
+
+  return result;
+}
+
+/*!
+ * \fn static Arena* current()
+ * \brief returns the current arena of the calling thread, or nullptr
+ */
+Arena* Arena::current()
+{
+  return current_arena.get();
+}
+
+
+ArenaScope::ArenaScope(std::shared_ptr<Arena> arena)
+  : m_previous(std::move(current_arena))
+{
+  current_arena = std::move(arena);
+}
+
+ArenaScope::~ArenaScope()
+{
+  current_arena = std::move(m_previous);
+}
+
+const std::shared_ptr<Arena>& ArenaScope::current()
+{
+  return current_arena;
+}
+
+} // namespace ast
+
+} // namespace script
@@ -43,7 +43,7 @@ void AST::add(const std::shared_ptr<Statement> & statement)
 
 size_t AST::offset(utils::StringView sv) const
 {
-  return sv.data() - source.content().data();
+  return sv.data() - source.data();
 }
 
 SourceFile::Position AST::position(const parser::Token& tok) const
@@ -342,7 +342,7 @@ std::shared_ptr<FunctionCall> FunctionCall::New(const std::shared_ptr<Expression
   std::vector<std::shared_ptr<Expression>> && arguments,
   const parser::Token & rightPar)
 {
-  return std::make_shared<FunctionCall>(callee, leftPar, std::move(arguments), rightPar);
+  return make_node<FunctionCall>(callee, leftPar, std::move(arguments), rightPar);
 }
 
 
@@ -363,7 +363,7 @@ utils::StringView BraceConstruction::source() const
 
 std::shared_ptr<BraceConstruction> BraceConstruction::New(const std::shared_ptr<Identifier> & t, const parser::Token & lb, std::vector<std::shared_ptr<Expression>> && args, const parser::Token & rb)
 {
-  return std::make_shared<BraceConstruction>(t, lb, std::move(args), rb);
+  return make_node<BraceConstruction>(t, lb, std::move(args), rb);
 }
 
 
@@ -394,7 +394,7 @@ std::shared_ptr<ArraySubscript> ArraySubscript::New(const std::shared_ptr<Expres
   const std::shared_ptr<Expression> & i,
   const parser::Token & rb)
 {
-  return std::make_shared<ArraySubscript>(a, lb, i, rb);
+  return make_node<ArraySubscript>(a, lb, i, rb);
 }
 
 
@@ -426,12 +426,12 @@ bool Operation::isPostfix() const
 
 std::shared_ptr<Operation> Operation::New(const parser::Token & opTok, const std::shared_ptr<Expression> & arg)
 {
-  return std::make_shared<Operation>(opTok, arg);
+  return make_node<Operation>(opTok, arg);
 }
 
 std::shared_ptr<Operation> Operation::New(const parser::Token & opTok, const std::shared_ptr<Expression> & a1, const std::shared_ptr<Expression> & a2)
 {
-  return std::make_shared<Operation>(opTok, a1, a2);
+  return make_node<Operation>(opTok, a1, a2);
 }
 
 
@@ -458,7 +458,7 @@ std::shared_ptr<ConditionalExpression> ConditionalExpression::New(const std::sha
   const std::shared_ptr<Expression> & ifTrue, const parser::Token & colon,
   const std::shared_ptr<Expression> & ifFalse)
 {
-  return std::make_shared<ConditionalExpression>(cond, question, ifTrue, colon, ifFalse);
+  return make_node<ConditionalExpression>(cond, question, ifTrue, colon, ifFalse);
 }
 
 
@@ -471,7 +471,7 @@ ArrayExpression::ArrayExpression(const parser::Token & lb)
 
 std::shared_ptr<ArrayExpression> ArrayExpression::New(const parser::Token & lb)
 {
-  return std::make_shared<ArrayExpression>(lb);
+  return make_node<ArrayExpression>(lb);
 }
 
 utils::StringView ArrayExpression::source() const
@@ -489,7 +489,7 @@ ListExpression::ListExpression(const parser::Token & lb)
 
 std::shared_ptr<ListExpression> ListExpression::New(const parser::Token & lb)
 {
-  return std::make_shared<ListExpression>(lb);
+  return make_node<ListExpression>(lb);
 }
 
 utils::StringView ListExpression::source() const
@@ -511,7 +511,7 @@ bool Statement::isDeclaration() const
 
 std::shared_ptr<NullStatement> NullStatement::New(const parser::Token & semicolon)
 {
-  return std::make_shared<NullStatement>(semicolon);
+  return make_node<NullStatement>(semicolon);
 }
 
 
@@ -530,7 +530,7 @@ ExpressionStatement::~ExpressionStatement()
 
 std::shared_ptr<ExpressionStatement> ExpressionStatement::New(const std::shared_ptr<Expression> & expr, const parser::Token & semicolon)
 {
-  return std::make_shared<ExpressionStatement>(expr, semicolon);
+  return make_node<ExpressionStatement>(expr, semicolon);
 }
 
 
@@ -548,7 +548,7 @@ CompoundStatement::~CompoundStatement()
 
 std::shared_ptr<CompoundStatement> CompoundStatement::New(const parser::Token & leftBrace, const parser::Token & rightBrace)
 {
-  return std::make_shared<CompoundStatement>(leftBrace, rightBrace);
+  return make_node<CompoundStatement>(leftBrace, rightBrace);
 }
 
 
@@ -571,7 +571,7 @@ IfStatement::~IfStatement()
 
 std::shared_ptr<IfStatement> IfStatement::New(const parser::Token & keyword)
 {
-  return std::make_shared<IfStatement>(keyword);
+  return make_node<IfStatement>(keyword);
 }
 
 
@@ -589,7 +589,7 @@ WhileLoop::WhileLoop(const parser::Token & whileKw)
 
 std::shared_ptr<WhileLoop> WhileLoop::New(const parser::Token & keyword)
 {
-  return std::make_shared<WhileLoop>(keyword);
+  return make_node<WhileLoop>(keyword);
 }
 
 utils::StringView WhileLoop::source() const
@@ -605,7 +605,7 @@ ForLoop::ForLoop(const parser::Token & forKw)
 
 std::shared_ptr<ForLoop> ForLoop::New(const parser::Token & keyword)
 {
-  return std::make_shared<ForLoop>(keyword);
+  return make_node<ForLoop>(keyword);
 }
 
 utils::StringView ForLoop::source() const
@@ -628,7 +628,7 @@ BreakStatement::BreakStatement(const parser::Token & kw)
 
 std::shared_ptr<BreakStatement> BreakStatement::New(const parser::Token & keyword)
 {
-  return std::make_shared<BreakStatement>(keyword);
+  return make_node<BreakStatement>(keyword);
 }
 
 ContinueStatement::ContinueStatement(const parser::Token & kw)
@@ -639,7 +639,7 @@ ContinueStatement::ContinueStatement(const parser::Token & kw)
 
 std::shared_ptr<ContinueStatement> ContinueStatement::New(const parser::Token & keyword)
 {
-  return std::make_shared<ContinueStatement>(keyword);
+  return make_node<ContinueStatement>(keyword);
 }
 
 ReturnStatement::ReturnStatement(const parser::Token & kw)
@@ -650,7 +650,7 @@ ReturnStatement::ReturnStatement(const parser::Token & kw)
 
 std::shared_ptr<ReturnStatement> ReturnStatement::New(const parser::Token & keyword)
 {
-  return std::make_shared<ReturnStatement>(keyword);
+  return make_node<ReturnStatement>(keyword);
 }
 
 std::shared_ptr<ReturnStatement> ReturnStatement::New(const parser::Token & keyword, const std::shared_ptr<Expression> & value)
@@ -683,7 +683,7 @@ AttributeDeclaration::AttributeDeclaration(const parser::Token& dlb, const std::
 
 std::shared_ptr<AttributeDeclaration> AttributeDeclaration::New(const parser::Token& dlb, const std::shared_ptr<Node>& attr, const parser::Token& drb)
 {
-  return std::make_shared<AttributeDeclaration>(dlb, attr, drb);
+  return make_node<AttributeDeclaration>(dlb, attr, drb);
 }
 
 utils::StringView AttributeDeclaration::source() const
@@ -704,7 +704,7 @@ EnumDeclaration::EnumDeclaration(const parser::Token& ek, const parser::Token& c
 
 std::shared_ptr<EnumDeclaration> EnumDeclaration::New(const parser::Token& ek, const parser::Token& ck, const parser::Token& lb, const std::shared_ptr<SimpleIdentifier>& n, std::vector<EnumValueDeclaration> vals, const parser::Token& rb)
 {
-  return std::make_shared<EnumDeclaration>(ek, ck, lb, n, std::move(vals), rb);
+  return make_node<EnumDeclaration>(ek, ck, lb, n, std::move(vals), rb);
 }
 
 utils::StringView EnumDeclaration::source() const
@@ -723,7 +723,7 @@ ConstructorInitialization::ConstructorInitialization(const parser::Token &lp, st
 
 std::shared_ptr<ConstructorInitialization> ConstructorInitialization::New(const parser::Token &lp, std::vector<std::shared_ptr<Expression>> && args, const parser::Token &rp)
 {
-  return std::make_shared<ConstructorInitialization>(lp, std::move(args), rp);
+  return make_node<ConstructorInitialization>(lp, std::move(args), rp);
 }
 
 utils::StringView ConstructorInitialization::source() const
@@ -741,7 +741,7 @@ BraceInitialization::BraceInitialization(const parser::Token & lb, std::vector<s
 
 std::shared_ptr<BraceInitialization> BraceInitialization::New(const parser::Token & lb, std::vector<std::shared_ptr<Expression>> && args, const parser::Token & rb)
 {
-  return std::make_shared<BraceInitialization>(lb, std::move(args), rb);
+  return make_node<BraceInitialization>(lb, std::move(args), rb);
 }
 
 utils::StringView BraceInitialization::source() const
@@ -758,7 +758,7 @@ AssignmentInitialization::AssignmentInitialization(const parser::Token & eq, con
 
 std::shared_ptr<AssignmentInitialization> AssignmentInitialization::New(const parser::Token & eq, const std::shared_ptr<Expression> & val)
 {
-  return std::make_shared<AssignmentInitialization>(eq, val);
+  return make_node<AssignmentInitialization>(eq, val);
 }
 
 utils::StringView AssignmentInitialization::source() const
@@ -776,7 +776,7 @@ VariableDecl::VariableDecl(const QualifiedType & t, const std::shared_ptr<Simple
 
 std::shared_ptr<VariableDecl> VariableDecl::New(const QualifiedType & t, const std::shared_ptr<SimpleIdentifier> & name)
 {
-  return std::make_shared<VariableDecl>(t, name);
+  return make_node<VariableDecl>(t, name);
 }
 
 utils::StringView VariableDecl::source() const
@@ -873,12 +873,12 @@ utils::StringView FunctionDecl::parameterName(int index) const
 
 std::shared_ptr<FunctionDecl> FunctionDecl::New(const std::shared_ptr<Identifier> & name)
 {
-  return std::make_shared<FunctionDecl>(name);
+  return make_node<FunctionDecl>(name);
 }
 
 std::shared_ptr<FunctionDecl> FunctionDecl::New()
 {
-  return std::make_shared<FunctionDecl>();
+  return make_node<FunctionDecl>();
 }
 
 
@@ -895,7 +895,7 @@ ConstructorDecl::ConstructorDecl(const std::shared_ptr<Identifier> & name)
 
 std::shared_ptr<ConstructorDecl> ConstructorDecl::New(const std::shared_ptr<Identifier> & name)
 {
-  return std::make_shared<ConstructorDecl>(name);
+  return make_node<ConstructorDecl>(name);
 }
 
 DestructorDecl::DestructorDecl(const std::shared_ptr<Identifier> & name)
@@ -910,7 +910,7 @@ utils::StringView DestructorDecl::source() const
 
 std::shared_ptr<DestructorDecl> DestructorDecl::New(const std::shared_ptr<Identifier> & name)
 {
-  return std::make_shared<DestructorDecl>(name);
+  return make_node<DestructorDecl>(name);
 }
 
 OperatorOverloadDecl::OperatorOverloadDecl(const std::shared_ptr<Identifier> & name)
@@ -919,7 +919,7 @@ OperatorOverloadDecl::OperatorOverloadDecl(const std::shared_ptr<Identifier> & n
 
 std::shared_ptr<OperatorOverloadDecl> OperatorOverloadDecl::New(const std::shared_ptr<Identifier> & name)
 {
-  return std::make_shared<OperatorOverloadDecl>(name);
+  return make_node<OperatorOverloadDecl>(name);
 }
 
 CastDecl::CastDecl(const QualifiedType & rt)
@@ -930,7 +930,7 @@ CastDecl::CastDecl(const QualifiedType & rt)
 
 std::shared_ptr<CastDecl> CastDecl::New(const QualifiedType & rt)
 {
-  return std::make_shared<CastDecl>(rt);
+  return make_node<CastDecl>(rt);
 }
 
 utils::StringView CastDecl::source() const
@@ -953,7 +953,7 @@ utils::StringView LambdaExpression::parameterName(int index) const
 
 std::shared_ptr<LambdaExpression> LambdaExpression::New(const parser::Token & lb)
 {
-  return std::make_shared<LambdaExpression>(lb);
+  return make_node<LambdaExpression>(lb);
 }
 
 utils::StringView LambdaExpression::source() const
@@ -973,7 +973,7 @@ Typedef::Typedef(const parser::Token & typedef_tok, const QualifiedType & qtype,
 
 std::shared_ptr<Typedef> Typedef::New(const parser::Token & typedef_tok, const QualifiedType & qtype, const std::shared_ptr<ast::SimpleIdentifier> & n)
 {
-  return std::make_shared<Typedef>(typedef_tok, qtype, n);
+  return make_node<Typedef>(typedef_tok, qtype, n);
 }
 
 utils::StringView Typedef::source() const
@@ -994,7 +994,7 @@ NamespaceDeclaration::NamespaceDeclaration(const parser::Token & ns_tok, const s
 
 std::shared_ptr<NamespaceDeclaration> NamespaceDeclaration::New(const parser::Token & ns_tok, const std::shared_ptr<ast::SimpleIdentifier> & n, const parser::Token & lb, std::vector<std::shared_ptr<Statement>> && stats, const parser::Token & rb)
 {
-  return std::make_shared<NamespaceDeclaration>(ns_tok, n, lb, std::move(stats), rb);
+  return make_node<NamespaceDeclaration>(ns_tok, n, lb, std::move(stats), rb);
 }
 
 utils::StringView NamespaceDeclaration::source() const
@@ -1021,7 +1021,7 @@ ClassFriendDeclaration::ClassFriendDeclaration(const parser::Token & friend_tok,
 
 std::shared_ptr<ClassFriendDeclaration> ClassFriendDeclaration::New(const parser::Token & friend_tok, const parser::Token & class_tok, const std::shared_ptr<Identifier> & cname)
 {
-  return std::make_shared<ClassFriendDeclaration>(friend_tok, class_tok, cname);
+  return make_node<ClassFriendDeclaration>(friend_tok, class_tok, cname);
 }
 
 utils::StringView ClassFriendDeclaration::source() const
@@ -1040,7 +1040,7 @@ UsingDeclaration::UsingDeclaration(const parser::Token & using_tok, const std::s
 
 std::shared_ptr<UsingDeclaration> UsingDeclaration::New(const parser::Token & using_tok, const std::shared_ptr<ScopedIdentifier> & name)
 {
-  return std::make_shared<UsingDeclaration>(using_tok, name);
+  return make_node<UsingDeclaration>(using_tok, name);
 }
 
 utils::StringView UsingDeclaration::source() const
@@ -1060,7 +1060,7 @@ UsingDirective::UsingDirective(const parser::Token & using_tok, const parser::To
 
 std::shared_ptr<UsingDirective> UsingDirective::New(const parser::Token & using_tok, const parser::Token & namespace_tok, const std::shared_ptr<Identifier> & name)
 {
-  return std::make_shared<UsingDirective>(using_tok, namespace_tok, name);
+  return make_node<UsingDirective>(using_tok, namespace_tok, name);
 }
 
 utils::StringView UsingDirective::source() const
@@ -1081,7 +1081,7 @@ NamespaceAliasDefinition::NamespaceAliasDefinition(const parser::Token & namespa
 
 std::shared_ptr<NamespaceAliasDefinition> NamespaceAliasDefinition::New(const parser::Token & namespace_tok, const std::shared_ptr<SimpleIdentifier> & a, const parser::Token & equal_tok, const std::shared_ptr<Identifier> & b)
 {
-  return std::make_shared<NamespaceAliasDefinition>(namespace_tok, a, equal_tok, b);
+  return make_node<NamespaceAliasDefinition>(namespace_tok, a, equal_tok, b);
 }
 
 utils::StringView NamespaceAliasDefinition::source() const
@@ -1102,7 +1102,7 @@ TypeAliasDeclaration::TypeAliasDeclaration(const parser::Token & using_tok, cons
 
 std::shared_ptr<TypeAliasDeclaration> TypeAliasDeclaration::New(const parser::Token & using_tok, const std::shared_ptr<SimpleIdentifier> & a, const parser::Token & equal_tok, const std::shared_ptr<Identifier> & b)
 {
-  return std::make_shared<TypeAliasDeclaration>(using_tok, a, equal_tok, b);
+  return make_node<TypeAliasDeclaration>(using_tok, a, equal_tok, b);
 }
 
 utils::StringView TypeAliasDeclaration::source() const
@@ -1121,7 +1121,7 @@ ImportDirective::ImportDirective(const parser::Token & exprt, const parser::Toke
 
 std::shared_ptr<ImportDirective> ImportDirective::New(const parser::Token & exprt, const parser::Token & imprt, std::vector<parser::Token> && nms)
 {
-  return std::make_shared<ImportDirective>(exprt, imprt, std::move(nms));
+  return make_node<ImportDirective>(exprt, imprt, std::move(nms));
 }
 
 utils::StringView ImportDirective::source() const
@@ -1176,7 +1176,7 @@ bool TemplateDeclaration::is_partial_specialization() const
 
 std::shared_ptr<TemplateDeclaration> TemplateDeclaration::New(const parser::Token& tmplt_k, const parser::Token& left_angle_b, std::vector<TemplateParameter>&& params, const parser::Token& right_angle_b, const std::shared_ptr<Declaration>& decl)
 {
-  return std::make_shared<TemplateDeclaration>(tmplt_k, left_angle_b, std::move(params), right_angle_b, decl);
+  return make_node<TemplateDeclaration>(tmplt_k, left_angle_b, std::move(params), right_angle_b, decl);
 }
 
 utils::StringView TemplateDeclaration::source() const
@@ -1192,7 +1192,7 @@ ScriptRootNode::ScriptRootNode(const std::shared_ptr<AST> & st)
 
 std::shared_ptr<ScriptRootNode> ScriptRootNode::New(const std::shared_ptr<AST> & syntaxtree)
 {
-  return std::make_shared<ScriptRootNode>(syntaxtree);
+  return make_node<ScriptRootNode>(syntaxtree);
 }
 
 utils::StringView ScriptRootNode::source() const
@@ -12,6 +12,7 @@
 #include "script/object.h"
 #include "script/script.h"
 #include "script/staticdatamember.h"
+#include "script/typesystem.h"
 #include "script/userdata.h"
 
 #include "script/private/class_p.h"
@@ -21,6 +22,7 @@
 #include "script/private/lambda_p.h"
 #include "script/private/namespace_p.h"
 #include "script/private/template_p.h"
+#include "script/private/typesystem_p.h"
 #include "script/private/value_p.h"
 
 namespace script
@@ -388,6 +390,7 @@ const std::vector<Function>& Class::memberFunctions() const
 void Class::addMethod(const Function& f)
 {
   d->register_function(f);
+  engine()->implementation()->overload_resolution_cache.invalidate(f);
 }
 
 /*!
@@ -406,6 +409,12 @@ void Class::addFunction(const Function& f)
     d->destructor = f;
   else
     d->register_function(f);
+
+  // constructors and conversion functions take part in user-defined conversions
+  if (f.isCast() || f.isConstructor())
+    engine()->typeSystem()->impl()->conversions.clear();
+
+  engine()->implementation()->overload_resolution_cache.invalidate(f);
 }
 
 /*!
@@ -446,6 +455,7 @@ void ClassImpl::set_parent(const Class & p)
     return;
   this->parent = p.impl();
   this->isAbstract = p.isAbstract();
+  this->engine->typeSystem()->impl()->conversions.clear();
   this->virtualMembers = p.vtable();
 }
 
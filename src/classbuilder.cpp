@@ -113,7 +113,7 @@ Class ClassTemplateSpecializationBuilder::get()
   Class class_result{ ret };
   template_.engine()->typeSystem()->impl()->register_class(class_result, this->id);
 
-  template_.impl()->instances[class_result.arguments()] = class_result;
+  template_.impl()->instances.insert(class_result.arguments(), class_result);
 
   return class_result;
 }
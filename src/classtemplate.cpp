@@ -7,8 +7,11 @@
 
 #include "script/class.h"
 #include "script/classtemplatespecializationbuilder.h"
+#include "script/engine.h"
 #include "script/templateargumentprocessor.h"
 
+#include "script/compiler/profiler.h"
+
 #include "script/private/templateargumentscope_p.h"
 
 namespace script
@@ -27,13 +30,7 @@ ClassTemplateNativeBackend* ClassTemplate::backend() const
 
 bool ClassTemplate::hasInstance(const std::vector<TemplateArgument> & args, Class *value) const
 {
-  auto d = impl();
-  auto it = d->instances.find(args);
-  if (it == d->instances.end())
-    return false;
-  if (value != nullptr)
-    *value = it->second;
-  return true;
+  return impl()->instances.find(args, value);
 }
 
 Class ClassTemplate::getInstance(const std::vector<TemplateArgument> & args)
@@ -47,11 +44,16 @@ Class ClassTemplate::getInstance(const std::vector<TemplateArgument> & args)
 
   auto d = impl();
 
+  compiler::Profiler::Timer timer{ compiler::Profiler::Phase::TemplateInstantiation };
+
   TemplateArgumentProcessor tnp;
   ret = tnp.instantiate(*this, args);
 
+  if (timer.isActive())
+    timer.setName(engine()->toString(ret.id()));
+
   /// TODO : this might be unnecessary
-  d->instances[args] = ret;
+  d->instances.insert(args, ret);
 
   return ret;
 }
@@ -75,7 +77,7 @@ const std::vector<PartialTemplateSpecialization> & ClassTemplate::partialSpecial
 const std::map<std::vector<TemplateArgument>, Class, TemplateArgumentComparison> & ClassTemplate::instances() const
 {
   auto d = impl();
-  return d->instances;
+  return d->instances.map();
 }
 
 std::shared_ptr<ClassTemplateImpl> ClassTemplate::impl() const
@@ -14,20 +14,31 @@
 #include "script/classtemplateinstancebuilder.h"
 
 #include "script/parser/parser.h"
+#include "script/parser/token-stream.h"
 
 #include "script/compiler/commandcompiler.h"
 #include "script/compiler/compilererrors.h"
 #include "script/compiler/functioncompiler.h"
+#include "script/compiler/profiler.h"
+#include "script/compiler/readonlyengine.h"
 #include "script/compiler/scriptcompiler.h"
 
 #include "script/private/class_p.h"
 #include "script/private/function_p.h"
+#include "script/private/programfunction.h"
 #include "script/private/scope_p.h"
 #include "script/private/script_p.h"
+#include "script/private/sourcefile_p.h"
 #include "script/private/template_p.h"
 
+#include "script/ast/arena.h"
+#include "script/ast/node.h"
+
+#include <algorithm>
+#include <atomic>
 #include <exception>
 #include <limits>
+#include <thread>
 
 namespace script
 {
@@ -44,6 +55,7 @@ SessionManager::SessionManager(Compiler *c)
 
   c->mSession = std::make_shared<CompileSession>(c);
   mStartedSession = true;
+  start_profiling();
 }
 
 SessionManager::SessionManager(Compiler* c, const Script& s, CompileMode m)
@@ -59,12 +71,34 @@ SessionManager::SessionManager(Compiler* c, const Script& s, CompileMode m)
 
   c->mSession = std::make_shared<CompileSession>(c, s, m);
   mStartedSession = true;
+  start_profiling();
 }
 
 SessionManager::~SessionManager()
 {
   if (mStartedSession)
+  {
     mCompiler->session()->setState(CompileSession::State::Finished);
+    // the nodes may not outlive the arena of their ast: a failed compilation 
+    // may leave declarations of a destroyed script in the queues
+    mCompiler->session()->current_node = nullptr;
+    if (mCompiler->session()->error || std::uncaught_exception())
+      mCompiler->mScriptCompiler.reset();
+    Profiler::setCurrent(mPreviousProfiler);
+  }
+}
+
+/*
+ * Makes the profiler of the compiler current on this thread for the 
+ * duration of the session; a session started by another compiler 
+ * (e.g. while compiling an expression) is profiled by the outer one.
+ */
+void SessionManager::start_profiling()
+{
+  mPreviousProfiler = Profiler::current();
+
+  if (mCompiler->profiler().isEnabled())
+    Profiler::setCurrent(&mCompiler->profiler());
 }
 
 
@@ -160,7 +194,8 @@ void Component::log(const diagnostic::DiagnosticMessage& mssg)
 
 Compiler::Compiler(Engine *e)
   : mEngine(e),
-    mMessageBuilder(std::make_shared<diagnostic::MessageBuilder>(e))
+    mMessageBuilder(std::make_shared<diagnostic::MessageBuilder>(e)),
+    mProfiler(std::make_unique<Profiler>())
 {
 
 }
@@ -175,11 +210,76 @@ bool Compiler::hasActiveSession() const
   return mSession != nullptr && mSession->state() != CompileSession::State::Finished;
 }
 
+/*!
+ * \fn void setThreadCount(size_t n)
+ * \param number of threads
+ * \brief sets the number of threads used to parse scripts and compile the bodies of functions
+ *
+ * With more than one thread, large scripts (512 KiB and more) are parsed on 
+ * several threads, and the bodies of functions are compiled on several 
+ * threads once all declarations have been processed. 
+ * Functions whose compilation needs to modify the engine (e.g. to instantiate 
+ * a template or to create a lambda) are then compiled again on the calling thread.
+ * Bodies are set and diagnostics are reported in the order in which the 
+ * functions were scheduled, so that the result does not depend on the 
+ * number of threads.
+ * Debug compilations always use a single thread.
+ */
+void Compiler::setThreadCount(size_t n)
+{
+  mThreadCount = std::max<size_t>(n, 1);
+}
+
+/*!
+ * \fn void setLazyCompilation(bool on)
+ * \param whether lazy compilation is enabled
+ * \brief enables or disables lazy compilation of function bodies
+ *
+ * When enabled, compiling a script only processes its declarations: 
+ * the body of a function is compiled when the function is called for 
+ * the first time, or when compileAll() is called on its script.
+ * Errors in a body are then reported in the messages of the script and 
+ * the call throws a RuntimeError.
+ * Debug compilations and the root function of a script are never deferred.
+ *
+ * The ast of a script is kept as long as some of its functions are not compiled.
+ */
+void Compiler::setLazyCompilation(bool on)
+{
+  mLazyCompilation = on;
+}
+
+/*!
+ * \fn Profiler& profiler()
+ * \brief returns the profiler of the compiler
+ *
+ * The profiler is disabled by default; once enabled, it records the 
+ * time spent in each phase of the following compilations, and in 
+ * each declaration, function body and template instance.
+ */
+Profiler& Compiler::profiler()
+{
+  return *mProfiler;
+}
+
+/*!
+ * \fn const Profiler& profiler() const
+ * \brief returns the profiler of the compiler
+ */
+const Profiler& Compiler::profiler() const
+{
+  return *mProfiler;
+}
+
 bool Compiler::compile(Script s, CompileMode mode)
 {
   SessionManager manager{ this, s, mode };
   assert(manager.started_session());
 
+  Profiler::Timer timer{ Profiler::Phase::Compilation };
+  if (timer.isActive())
+    timer.setName(s.path());
+
   ScriptCompiler *sc = getScriptCompiler();
 
   try
@@ -210,6 +310,383 @@ bool Compiler::compile(Script s, CompileMode mode)
   return true;
 }
 
+/*!
+ * \fn bool compile(const Function& f)
+ * \param function
+ * \brief compiles the body of a function whose compilation was deferred
+ *
+ * Returns true if the function was compiled, or if its compilation was not deferred.
+ * On failure, the errors are appended to the messages of the function's script; 
+ * the compilation is not attempted again and later calls return false.
+ * \sa setLazyCompilation()
+ */
+bool Compiler::compile(const Function& f)
+{
+  Script s = f.script();
+
+  if (s.isNull())
+    return true;
+
+  // the errors were reported by the first attempt
+  if (s.impl()->failed_functions.count(f.impl().get()))
+    return false;
+
+  const auto& index = s.impl()->deferred_functions_index;
+  auto it = index.find(f.impl().get());
+
+  if (it == index.end())
+    return true;
+
+  bool success = false;
+
+  {
+    // copied because compiling the function removes it from the script
+    CompileFunctionTask task = s.impl()->deferred_functions.at(it->second);
+    success = compileDeferred(task);
+  }
+
+  // done once the session and the task, which reference nodes of the ast, are destroyed
+  if (s.impl()->deferred_functions_index.empty())
+    s.impl()->apply_retention_policy(s.impl()->deferred_retention);
+
+  return success;
+}
+
+/*!
+ * \fn bool compileAll(Script s)
+ * \param script
+ * \brief compiles all the functions of a script whose compilation was deferred
+ *
+ * Returns false if any of these functions failed to compile.
+ * \sa setLazyCompilation()
+ */
+bool Compiler::compileAll(Script s)
+{
+  std::vector<CompileFunctionTask> tasks;
+
+  for (const CompileFunctionTask& t : s.impl()->deferred_functions)
+  {
+    if (!t.function.isNull())
+      tasks.push_back(t);
+  }
+
+  bool success = s.impl()->failed_functions.empty();
+
+  for (const CompileFunctionTask& t : tasks)
+    success = compileDeferred(t) && success;
+
+  tasks.clear();
+
+  if (s.impl()->deferred_functions_index.empty())
+    s.impl()->apply_retention_policy(s.impl()->deferred_retention);
+
+  return success;
+}
+
+/*
+ * Removes a function from the deferred functions of its script.
+ */
+static void remove_deferred_function(ScriptImpl& impl, const FunctionImpl* f)
+{
+  auto it = impl.deferred_functions_index.find(f);
+
+  if (it == impl.deferred_functions_index.end())
+    return;
+
+  impl.deferred_functions.at(it->second) = CompileFunctionTask{};
+  impl.deferred_functions_index.erase(it);
+
+  if (impl.deferred_functions_index.empty())
+    impl.deferred_functions.clear();
+}
+
+static std::vector<DiagnosticMessage>::const_iterator find_new_error(const std::vector<DiagnosticMessage>& messages, size_t offset)
+{
+  return std::find_if(messages.begin() + offset, messages.end(), [](const DiagnosticMessage& mssg) {
+    return mssg.severity() == diagnostic::Severity::Error;
+  });
+}
+
+bool Compiler::compileDeferred(const CompileFunctionTask& task)
+{
+  Script s = task.function.script();
+  ScriptImpl& impl = *s.impl();
+
+  SessionManager manager{ this };
+
+  Script current_script = session()->current_script;
+  const size_t message_count = session()->messages.size();
+
+  if (manager.started_session())
+    session()->script = s;
+
+  session()->current_script = s;
+
+  bool compiled = false;
+
+  try
+  {
+    FunctionCompiler fc{ this };
+    fc.compile(task);
+
+    compiled = true;
+    remove_deferred_function(impl, task.function.impl().get());
+
+    if (manager.started_session())
+    {
+      finalizeSession();
+    }
+    else if (session()->state() == CompileSession::State::CompilingFunctions)
+    {
+      processAllDeclarations();
+      compileFunctions();
+    }
+  }
+  catch (CompilationFailure& ex)
+  {
+    ex.location = session()->location();
+    session()->log(ex);
+  }
+  catch (const NotImplemented& ex)
+  {
+    session()->log(DiagnosticMessage{ diagnostic::Severity::Error, ex.errorCode(), "NotImplemented: " + ex.message });
+  }
+
+  // the function is not compiled again so that its errors are reported once
+  if (!compiled)
+  {
+    remove_deferred_function(impl, task.function.impl().get());
+
+    auto error = find_new_error(session()->messages, message_count);
+    impl.failed_functions[task.function.impl().get()] = error != session()->messages.end() ? *error : DiagnosticMessage{};
+  }
+
+  session()->current_script = current_script;
+
+  if (!manager.started_session())
+  {
+    // the enclosing session may have failed before this function was compiled
+    return compiled && find_new_error(session()->messages, message_count) == session()->messages.end();
+  }
+
+  if (session()->error)
+  {
+    session()->clear();
+
+    for (diagnostic::DiagnosticMessage& mssg : session()->messages)
+      impl.messages.push_back(std::move(mssg));
+
+    return false;
+  }
+
+  return true;
+}
+
+static utils::StringView statement_text(const std::vector<parser::Token>& tokens)
+{
+  const char* begin = tokens.front().text().data();
+  const char* end = tokens.back().text().data() + tokens.back().text().size();
+  return utils::StringView(begin, std::distance(begin, end));
+}
+
+/*
+ * Compares the top-level statements of two versions of a source and collects 
+ * the (reparsed) declarations of the functions whose body changed; 
+ * these are allocated in \a arena.
+ * Returns false if any other kind of change was made, if a change moved 
+ * the lines of a statement, or if the source contains directives that alter 
+ * the scope in which functions are compiled.
+ */
+static bool collect_modified_functions(const SourceFile& before, const SourceFile& after, const std::shared_ptr<ast::Arena>& arena, std::vector<std::shared_ptr<ast::FunctionDecl>>& result)
+{
+  ast::ArenaScope arena_scope{ arena };
+
+  parser::TokenStream old_stream{ before.data(), before.size() };
+  parser::TokenStream new_stream{ after.data(), after.size() };
+  std::vector<parser::Token> old_tokens;
+  auto context = std::make_shared<parser::ParserContext>(after.data(), std::vector<parser::Token>());
+
+  for (;;)
+  {
+    const bool has_old = old_stream.readStatement(old_tokens);
+    const bool has_new = context->refill(new_stream);
+
+    if (has_old != has_new)
+      return false;
+    else if (!has_old)
+      return true;
+
+    const parser::Token& first = context->tokens().front();
+    if (first == parser::Token::Import || first == parser::Token::Using)
+      return false;
+
+    utils::StringView old_text = statement_text(old_tokens);
+    utils::StringView new_text = statement_text(context->tokens());
+
+    // the lines of the functions that are kept must not move
+    if (before.map(std::distance(before.data(), old_text.data())).line != after.map(std::distance(after.data(), new_text.data())).line
+      || std::count(old_text.data(), old_text.data() + old_text.size(), '\n') != std::count(new_text.data(), new_text.data() + new_text.size(), '\n'))
+      return false;
+
+    if (old_text == new_text)
+      continue;
+
+    parser::ProgramParser p{ context };
+    std::shared_ptr<ast::Statement> stmt = p.parseStatement();
+
+    if (!p.atEnd() || stmt->type() != ast::NodeType::FunctionDeclaration)
+      return false;
+
+    auto decl = std::static_pointer_cast<ast::FunctionDecl>(stmt);
+
+    if (!decl->name->is<ast::SimpleIdentifier>() || decl->body == nullptr)
+      return false;
+
+    // a change in the body could change a deduced return type
+    if (decl->returnType.type->is<ast::SimpleIdentifier>() && decl->returnType.type->as<ast::SimpleIdentifier>().name == parser::Token::Auto)
+      return false;
+
+    const size_t signature_length = std::distance(new_text.data(), decl->body->openingBrace.text().data()) + 1;
+
+    if (old_text.size() < signature_length || std::memcmp(old_text.data(), new_text.data(), signature_length) != 0)
+      return false;
+
+    result.push_back(decl);
+  }
+}
+
+/*!
+ * \fn bool recompile(Script s, const SourceFile& src, CompileMode mode)
+ * \param compiled script
+ * \param new version of the script's source
+ * \param compilation mode
+ * \brief Recompiles a script after a change of its source.
+ *
+ * If the only top-level declarations that changed are the bodies of functions 
+ * of the script's root namespace, only these declarations are reparsed and only 
+ * the bodies of these functions are recompiled; all the other Function and Class 
+ * objects of the script are kept as-is.
+ * Otherwise, or if the change moved some lines, the script is reset and compiled 
+ * again from scratch.
+ * Debug compilations are always done from scratch, so that every breakpoint 
+ * refers to the current source.
+ */
+bool Compiler::recompile(Script s, const SourceFile& src, CompileMode mode)
+{
+  SourceFile updated = src;
+  if (!updated.isLoaded())
+    updated.load();
+
+  // the new source replaces the one of the script, which outlives this call
+  updated.impl()->copy_mapping();
+
+  // declared first as it stores the reparsed declarations
+  auto arena = std::make_shared<ast::Arena>();
+  std::vector<std::shared_ptr<ast::FunctionDecl>> modified;
+  bool incremental = mode != CompileMode::Debug && s.isReady() && !s.impl()->ast_locked() && s.source().isLoaded();
+
+  try
+  {
+    incremental = incremental && collect_modified_functions(s.source(), updated, arena, modified);
+  }
+  catch (const parser::SyntaxError&)
+  {
+    incremental = false;
+  }
+  catch (const std::runtime_error&)
+  {
+    incremental = false;
+  }
+
+  if (incremental)
+  {
+    SessionManager manager{ this, s, mode };
+    assert(manager.started_session());
+
+    ScriptCompiler* sc = getScriptCompiler();
+
+    try
+    {
+      for (const auto& decl : modified)
+      {
+        if (!sc->reschedule(s, decl))
+        {
+          incremental = false;
+          break;
+        }
+      }
+    }
+    catch (CompilationFailure&)
+    {
+      incremental = false;
+    }
+
+    if (incremental)
+    {
+      // the previous bodies, source and ast are restored if a body fails to compile
+      std::vector<std::pair<std::shared_ptr<FunctionImpl>, std::shared_ptr<program::Statement>>> previous_bodies;
+
+      for (std::queue<CompileFunctionTask> tasks = sc->compileTasks(); !tasks.empty(); tasks.pop())
+        previous_bodies.emplace_back(tasks.front().function.impl(), tasks.front().function.impl()->body());
+
+      SourceFile previous_source = s.impl()->source;
+      std::shared_ptr<ast::AST> previous_ast = s.impl()->ast;
+
+      s.impl()->source = updated;
+      s.impl()->ast = nullptr;
+
+      // the reparsed declarations do not outlive this call, 
+      // so the compilation of their bodies cannot be deferred
+      const bool lazy = mLazyCompilation;
+      mLazyCompilation = false;
+
+      try
+      {
+        finalizeSession();
+      }
+      catch (CompilationFailure& ex)
+      {
+        ex.location = session()->location();
+        session()->log(ex);
+      }
+      catch (const NotImplemented& ex)
+      {
+        session()->log(DiagnosticMessage{ diagnostic::Severity::Error, ex.errorCode(), "NotImplemented: " + ex.message });
+      }
+      catch (...)
+      {
+        mLazyCompilation = lazy;
+        throw;
+      }
+
+      mLazyCompilation = lazy;
+
+      if (session()->error)
+      {
+        for (const auto& b : previous_bodies)
+          b.first->set_body(b.second);
+
+        s.impl()->source = previous_source;
+        s.impl()->ast = previous_ast;
+
+        session()->clear();
+        s.impl()->messages = std::move(session()->messages);
+        return false;
+      }
+
+      s.impl()->messages.clear();
+      return true;
+    }
+
+    std::queue<CompileFunctionTask>().swap(sc->compileTasks());
+    session()->clear();
+  }
+
+  engine()->implementation()->reset(s);
+  s.impl()->source = updated;
+  return compile(s, mode);
+}
+
 void Compiler::addToSession(Script s)
 {
   assert(hasActiveSession());
@@ -364,6 +841,235 @@ void Compiler::processAllDeclarations()
     sc->processNext();
 }
 
+// batches of functions smaller than this are compiled on a single thread
+static const size_t parallel_compilation_threshold = 32;
+
+namespace
+{
+
+struct ParallelCompileTask
+{
+  CompileFunctionTask task;
+  std::shared_ptr<program::CompoundStatement> body;
+  std::vector<diagnostic::DiagnosticMessage> messages;
+  bool deferred = false;
+  std::exception_ptr error;
+  // the state of the session when the error occurred
+  Script current_script;
+  std::shared_ptr<ast::Node> current_node;
+  parser::Token current_token;
+};
+
+struct ParallelCompilation
+{
+  Engine* engine;
+  Script script;
+  Script current_script;
+  CompileMode mode;
+  std::vector<ParallelCompileTask> tasks;
+  std::atomic<size_t> next{ 0 };
+};
+
+} // namespace
+
+static bool can_compile_in_parallel(const CompileFunctionTask& task)
+{
+  // the root function of a script registers the script's global variables
+  return dynamic_cast<const ScriptFunctionImpl*>(task.function.impl().get()) == nullptr;
+}
+
+/*
+ * Registers a task in the script of its function so that it is compiled 
+ * on first call.
+ * Returns false if the compilation of the function cannot be deferred.
+ */
+static bool defer_compilation(const CompileFunctionTask& task)
+{
+  // the root function of a script is run right after the script is compiled
+  if (task.declaration == nullptr || dynamic_cast<const ScriptFunctionImpl*>(task.function.impl().get()) != nullptr)
+    return false;
+
+  Script s = task.function.script();
+
+  if (s.isNull())
+    return false;
+
+  ScriptImpl& impl = *s.impl();
+  impl.deferred_functions_index[task.function.impl().get()] = impl.deferred_functions.size();
+  impl.deferred_functions.push_back(task);
+
+  return true;
+}
+
+static void compile_functions_worker(ParallelCompilation& state)
+{
+  // the calling thread also runs a worker, but the other threads are not profiled
+  Profiler* profiler = Profiler::current();
+  Profiler::setCurrent(nullptr);
+
+  // each thread has its own compiler, and thus its own sessions
+  Compiler compiler{ state.engine };
+  FunctionCompiler fc{ &compiler };
+  fc.setCompileMode(state.mode);
+
+  ReadOnlyEngine read_only;
+
+  for (size_t i = state.next++; i < state.tasks.size(); i = state.next++)
+  {
+    ParallelCompileTask& t = state.tasks[i];
+
+    SessionManager manager{ &compiler, state.script, state.mode };
+    compiler.session()->current_script = state.current_script;
+
+    try
+    {
+      t.body = fc.compileBody(t.task);
+    }
+    catch (const DeferredCompilation&)
+    {
+      t.deferred = true;
+      continue;
+    }
+    catch (...)
+    {
+      t.error = std::current_exception();
+      t.current_script = compiler.session()->current_script;
+      t.current_node = compiler.session()->current_node;
+      t.current_token = compiler.session()->current_token;
+    }
+
+    t.messages = std::move(compiler.session()->messages);
+  }
+
+  Profiler::setCurrent(profiler);
+}
+
+static void compile_functions_in_parallel(ParallelCompilation& state, size_t threads)
+{
+  // line tables are computed on first use, compute them before the workers may need them
+  auto compute_line_table = [](const Script& s) {
+    if (!s.isNull() && s.source().isLoaded())
+      s.source().map(0);
+  };
+
+  compute_line_table(state.current_script);
+
+  for (const ParallelCompileTask& t : state.tasks)
+    compute_line_table(t.task.function.script());
+
+  threads = std::min(threads, state.tasks.size());
+
+  std::vector<std::thread> workers;
+
+  for (size_t i(1); i < threads; ++i)
+  {
+    try
+    {
+      workers.emplace_back(compile_functions_worker, std::ref(state));
+    }
+    catch (const std::system_error&)
+    {
+      break;
+    }
+  }
+
+  compile_functions_worker(state);
+
+  for (std::thread& t : workers)
+    t.join();
+}
+
+/*
+ * Compiles the bodies of the scheduled functions.
+ * Consecutive functions that can be compiled in parallel are compiled by 
+ * batches; the functions that could not be compiled against a read-only 
+ * engine are compiled again when their results are merged, in order.
+ */
+void Compiler::compileFunctions()
+{
+  ScriptCompiler *sc = getScriptCompiler();
+  FunctionCompiler *fc = getFunctionCompiler();
+  auto & queue = sc->compileTasks();
+
+  const bool parallel = mThreadCount > 1 && session()->compile_mode == CompileMode::Release;
+  const bool lazy = mLazyCompilation && session()->compile_mode == CompileMode::Release;
+
+  while (!queue.empty())
+  {
+    if (lazy && defer_compilation(queue.front()))
+    {
+      queue.pop();
+      continue;
+    }
+
+    if (!parallel || !can_compile_in_parallel(queue.front()))
+    {
+      CompileFunctionTask task = queue.front();
+      queue.pop();
+      fc->compile(task);
+      continue;
+    }
+
+    ParallelCompilation state;
+    state.engine = engine();
+    state.script = session()->script;
+    state.current_script = session()->current_script;
+    state.mode = session()->compile_mode;
+
+    while (!queue.empty() && can_compile_in_parallel(queue.front()))
+    {
+      if (lazy && defer_compilation(queue.front()))
+      {
+        queue.pop();
+        continue;
+      }
+
+      ParallelCompileTask t;
+      t.task = queue.front();
+      queue.pop();
+      state.tasks.push_back(std::move(t));
+    }
+
+    if (state.tasks.size() < parallel_compilation_threshold)
+    {
+      for (const ParallelCompileTask& t : state.tasks)
+        fc->compile(t.task);
+
+      continue;
+    }
+
+    {
+      Profiler::Timer timer{ Profiler::Phase::FunctionBodies };
+      if (timer.isActive())
+        timer.setName(std::to_string(state.tasks.size()) + " functions (parallel)");
+
+      compile_functions_in_parallel(state, mThreadCount);
+    }
+
+    for (ParallelCompileTask& t : state.tasks)
+    {
+      if (t.deferred)
+      {
+        fc->compile(t.task);
+        continue;
+      }
+
+      for (const auto& mssg : t.messages)
+        session()->log(mssg);
+
+      if (t.error)
+      {
+        session()->current_script = t.current_script;
+        session()->current_node = t.current_node;
+        session()->current_token = t.current_token;
+        std::rethrow_exception(t.error);
+      }
+
+      t.task.function.impl()->set_body(t.body);
+    }
+  }
+}
+
 void Compiler::finalizeSession()
 {
   if (mScriptCompiler == nullptr)
@@ -379,15 +1085,7 @@ void Compiler::finalizeSession()
   while (session()->state() != CompileSession::State::Finished)
   {
     processAllDeclarations();
-
-    FunctionCompiler *fc = getFunctionCompiler();
-    auto & queue = sc->compileTasks();
-    while (!queue.empty())
-    {
-      CompileFunctionTask task = queue.front();
-      queue.pop();
-      fc->compile(task);
-    }
+    compileFunctions();
 
     if (sc->variableProcessor().empty())
     {
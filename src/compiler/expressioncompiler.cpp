@@ -20,6 +20,7 @@
 #include "script/arraytemplate.h"
 #include "script/datamember.h"
 #include "script/private/engine_p.h"
+#include "script/private/enum_p.h"
 #include "script/functiontype.h"
 #include "script/private/function_p.h"
 #include "script/initialization.h"
@@ -82,6 +83,25 @@ std::shared_ptr<program::LambdaExpression> LambdaProcessor::generate(ExpressionC
   }
 }
 
+static bool is_builtin_string_concatenation(const Operator & op)
+{
+  // member functions of String can only be provided by the StringBackend
+  return op.operatorId() == AdditionOperator
+    && op.isMemberFunction()
+    && op.memberOf().id() == Type::String
+    && op.returnType() == Type::String
+    && op.parameter(1).baseType() == Type::String;
+}
+
+static bool is_intrinsic_enum_assignment(const Operator & op, Engine *e)
+{
+  if (op.operatorId() != AssignmentOperator || !op.firstOperand().isEnumType())
+    return false;
+
+  Enum enm = e->typeSystem()->getEnum(op.firstOperand());
+  return enm.impl()->intrinsic && enm.getAssignmentOperator() == op;
+}
+
 ExpressionCompiler::ExpressionCompiler(Compiler* c)
   : Component(c)
 {
@@ -634,9 +654,37 @@ std::shared_ptr<program::Expression> ExpressionCompiler::generateBinaryOperation
   std::vector<std::shared_ptr<program::Expression>> args{ lhs, rhs };
   const auto & inits = resol.initializations;
   ValueConstructor::prepare(engine(), args, selected.prototype(), inits);
+
+  if (is_builtin_string_concatenation(selected))
+    return generateStringConcatenation(std::move(args));
+  else if (is_intrinsic_enum_assignment(selected, engine()))
+    return program::EnumAssignment::New(selected.returnType(), args.front(), args.back());
+
   return program::FunctionCall::New(selected, std::move(args));
 }
 
+std::shared_ptr<program::Expression> ExpressionCompiler::generateStringConcatenation(std::vector<std::shared_ptr<program::Expression>> && args)
+{
+  // a chain such as a + b + c is flattened so that the result is built 
+  // in a single pass rather than through a temporary for each '+'
+  std::vector<std::shared_ptr<program::Expression>> operands;
+
+  for (auto & a : args)
+  {
+    if (a->is<program::StringConcatenation>())
+    {
+      auto & concat = static_cast<program::StringConcatenation&>(*a);
+      operands.insert(operands.end(), concat.operands.begin(), concat.operands.end());
+    }
+    else
+    {
+      operands.push_back(std::move(a));
+    }
+  }
+
+  return program::StringConcatenation::New(std::move(operands));
+}
+
 std::shared_ptr<program::Expression> ExpressionCompiler::generateUnaryOperation(const std::shared_ptr<ast::Operation> & operation)
 {
   assert(operation->arg2 == nullptr);
@@ -10,6 +10,8 @@
 #include "script/compiler/compilesession.h"
 #include "script/compiler/debug-info.h"
 #include "script/compiler/diagnostichelper.h"
+#include "script/compiler/profiler.h"
+#include "script/compiler/readonlyengine.h"
 
 #include "script/compiler/assignmentcompiler.h"
 #include "script/compiler/constructorcompiler.h"
@@ -34,6 +36,8 @@
 #include "script/private/programfunction.h"
 #include "script/private/script_p.h"
 
+#include <limits>
+
 namespace script
 {
 
@@ -87,13 +91,12 @@ bool FunctionScope::lookup(const std::string & name, NameLookupImpl *nl) const
     return true;
   }
 
-  for (int i(mSp + mSize - 1); i >= mSp; --i)
+  const int index = mCompiler->mStack.lastIndexOf(utils::StringView(name.data(), name.size()), mSp + mSize);
+
+  if (index >= mSp)
   {
-    if (mCompiler->mStack[i].name == name)
-    {
-      nl->localIndex = i;
-      return true;
-    }
+    nl->localIndex = index;
+    return true;
   }
 
   return ExtensibleScope::lookup(name, nl);
@@ -150,6 +153,7 @@ Variable::Variable(const Type & t, utils::StringView n, size_t i, bool g, bool s
 int Stack::addVar(const Type & t, utils::StringView name)
 {
   this->data.push_back(Variable(t, name, this->data.size()));
+  mNames[name].push_back(this->data.size() - 1);
 
   if (enable_debug)
   {
@@ -161,13 +165,8 @@ int Stack::addVar(const Type & t, utils::StringView name)
 
 int Stack::indexOf(const std::string & var) const
 {
-  for (size_t i(0); i < data.size(); ++i)
-  {
-    if (this->data[i].name == var)
-      return static_cast<int>(i);
-  }
-
-  return -1;
+  auto it = mNames.find(utils::StringView(var.data(), var.size()));
+  return it != mNames.end() ? static_cast<int>(it->second.front()) : -1;
 }
 
 int Stack::lastIndexOf(const std::string & var) const
@@ -177,10 +176,29 @@ int Stack::lastIndexOf(const std::string & var) const
 
 int Stack::lastIndexOf(utils::StringView var) const
 {
-  for (size_t i(data.size()); i-- > 0; )
+  auto it = mNames.find(var);
+  return it != mNames.end() ? static_cast<int>(it->second.back()) : -1;
+}
+
+/*!
+ * \fn int lastIndexOf(utils::StringView var, size_t end) const
+ * \brief returns the index of the last variable named \a var that is below \a end
+ *
+ * Returns -1 if there is no such variable.
+ */
+int Stack::lastIndexOf(utils::StringView var, size_t end) const
+{
+  auto it = mNames.find(var);
+
+  if (it == mNames.end())
+    return -1;
+
+  const std::vector<size_t>& indices = it->second;
+
+  for (size_t i(indices.size()); i-- > 0; )
   {
-    if (this->data[i].name == var)
-      return static_cast<int>(i);
+    if (indices[i] < end)
+      return static_cast<int>(indices[i]);
   }
 
   return -1;
@@ -192,6 +210,11 @@ void Stack::destroy(size_t n)
 
   while (n-- > 0)
   {
+    auto it = mNames.find(data.back().name);
+    it->second.pop_back();
+    if (it->second.empty())
+      mNames.erase(it);
+
     data.pop_back();
 
     if (enable_debug && debuginfo)
@@ -199,6 +222,16 @@ void Stack::destroy(size_t n)
   }
 }
 
+size_t Stack::NameHash::operator()(utils::StringView name) const
+{
+  size_t h = name.size();
+
+  for (size_t i(0); i < name.size(); ++i)
+    h = h * 31 + static_cast<unsigned char>(name.data()[i]);
+
+  return h;
+}
+
 
 
 EnterScope::EnterScope(FunctionCompiler *c, FunctionScope::Category scp)
@@ -312,11 +345,42 @@ bool FunctionCompiler::isDebugCompilation() const
 }
 
 void FunctionCompiler::compile(const CompileFunctionTask & task)
+{
+  Profiler::Timer timer{ Profiler::Phase::FunctionBodies };
+  if (timer.isActive())
+    timer.setName(engine()->toString(task.function));
+
+  std::shared_ptr<program::CompoundStatement> body = compileBody(task);
+  /// TODO : add implicit return statement in void functions
+  mFunction.impl()->set_body(body);
+}
+
+/*!
+ * \fn std::shared_ptr<program::CompoundStatement> compileBody(const CompileFunctionTask & task)
+ * \brief compiles the body of a function without setting it
+ *
+ * Unlike compile(), this function does not modify the function.
+ */
+namespace
+{
+
+// the compiler keeps its FunctionCompiler, which must not keep a 
+// declaration after the arena of its ast is destroyed
+struct DeclarationReset
+{
+  std::shared_ptr<ast::Declaration>& declaration;
+  ~DeclarationReset() { declaration = nullptr; }
+};
+
+} // namespace
+
+std::shared_ptr<program::CompoundStatement> FunctionCompiler::compileBody(const CompileFunctionTask & task)
 {
   expr_.setCaller(task.function);
   
   mFunction = task.function;
   mDeclaration = task.declaration;
+  DeclarationReset reset{ mDeclaration };
   mBaseScope = task.scope;
   mCurrentScope = task.scope;
 
@@ -331,9 +395,7 @@ void FunctionCompiler::compile(const CompileFunctionTask & task)
   for (int i(0); i < proto.count(); ++i)
     std::dynamic_pointer_cast<FunctionScope>(mCurrentScope.impl())->add_var(argumentName(i), proto.at(i));
 
-  std::shared_ptr<program::CompoundStatement> body = generateBody();
-  /// TODO : add implicit return statement in void functions
-  mFunction.impl()->set_body(body);
+  return generateBody();
 }
 
 
@@ -663,9 +725,8 @@ void FunctionCompiler::insertBreakpoint(const ast::Statement& s)
   if (!isDebugCompilation())
     return;
 
-  // @TODO: optimize! map() is O(n)
   utils::StringView tok = s.base_token().text();
-  size_t off = std::distance(mFunction.script().source().content().data(), tok.data());
+  size_t off = std::distance(mFunction.script().source().data(), tok.data());
   SourceFile::Position pos = mFunction.script().source().map(off);
   int line = pos.line;
 
@@ -679,9 +740,8 @@ void FunctionCompiler::insertExitBreakpoint(size_t delta, const ast::Statement&
   if (!isDebugCompilation())
     return;
 
-  // @TODO: optimize! map() is O(n)
   utils::StringView src = s.source();
-  size_t off = std::distance(mFunction.script().source().content().data(), src.data()) + src.size() - 1;
+  size_t off = std::distance(mFunction.script().source().data(), src.data()) + src.size() - 1;
   SourceFile::Position pos = mFunction.script().source().map(off);
   int line = pos.line;
 
@@ -953,6 +1013,9 @@ void FunctionCompiler::processVariableCreation(const std::shared_ptr<ast::Variab
   }
   else
   {
+    // static variables are stored in the script
+    ReadOnlyEngine::check();
+
     mStack[stack_index].is_static = true;
 
     auto simpl = script().impl();
@@ -7,6 +7,7 @@
 #include "script/compiler/compiler.h"
 #include "script/compiler/compilererrors.h"
 #include "script/compiler/diagnostichelper.h"
+#include "script/compiler/readonlyengine.h"
 
 #include "script/ast/node.h"
 
@@ -28,6 +29,9 @@ ImportProcessor::ImportProcessor(Compiler *c)
 
 Scope ImportProcessor::process(const std::shared_ptr<ast::ImportDirective> & decl)
 {
+  // importing may load the module and is merged in the enclosing namespace scopes
+  ReadOnlyEngine::check();
+
   Module m = engine()->getModule(decl->at(0));
 
   if (m.isNull())
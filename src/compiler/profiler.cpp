@@ -0,0 +1,248 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "script/compiler/profiler.h"
+
+#include <algorithm>
+#include <ostream>
+
+namespace script
+{
+
+namespace compiler
+{
+
+static thread_local Profiler* current_profiler = nullptr;
+
+Profiler::Profiler()
+  : m_origin(std::chrono::steady_clock::now())
+{
+
+}
+
+Profiler::~Profiler()
+{
+  if (current_profiler == this)
+    current_profiler = nullptr;
+}
+
+/*!
+ * \fn void setEnabled(bool on)
+ * \param whether the profiler is enabled
+ * \brief enables or disables the profiler
+ *
+ * This takes effect at the start of the next compile session.
+ */
+void Profiler::setEnabled(bool on)
+{
+  m_enabled = on;
+}
+
+/*!
+ * \fn const Counter& counter(Phase p) const
+ * \param phase
+ * \brief returns the number of times a phase was entered and the time spent in it
+ *
+ * Nested occurrences of a phase (e.g. an instantiation triggering
+ * another one) are counted but their time is only accounted once.
+ */
+const Profiler::Counter & Profiler::counter(Phase p) const
+{
+  return m_counters[static_cast<size_t>(p)];
+}
+
+/*!
+ * \fn std::vector<Event> slowest(Phase p, size_t n) const
+ * \param phase
+ * \param maximum number of events
+ * \brief returns the longest events of a phase, longest first
+ */
+std::vector<Profiler::Event> Profiler::slowest(Phase p, size_t n) const
+{
+  std::vector<Event> result;
+
+  for (const Event & e : m_events)
+  {
+    if (e.phase == p)
+      result.push_back(e);
+  }
+
+  std::stable_sort(result.begin(), result.end(), [](const Event & a, const Event & b) {
+    return a.duration > b.duration;
+  });
+
+  if (result.size() > n)
+    result.resize(n);
+
+  return result;
+}
+
+/*!
+ * \fn void clear()
+ * \brief removes all events and resets the counters
+ */
+void Profiler::clear()
+{
+  m_origin = std::chrono::steady_clock::now();
+  m_events.clear();
+  m_dropped_events = 0;
+
+  for (size_t i(0); i < PhaseCount; ++i)
+    m_counters[i] = Counter{};
+}
+
+static void write_json_string(std::ostream & out, const std::string & str)
+{
+  static const char* hex = "0123456789abcdef";
+
+  out << '"';
+
+  for (char c : str)
+  {
+    switch (c)
+    {
+    case '"':
+      out << "\\\"";
+      break;
+    case '\\':
+      out << "\\\\";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    case '\t':
+      out << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+        out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+      else
+        out << c;
+      break;
+    }
+  }
+
+  out << '"';
+}
+
+static void write_microseconds(std::ostream & out, std::chrono::nanoseconds ns)
+{
+  const long long count = ns.count();
+  const int frac = static_cast<int>(count % 1000);
+  out << (count / 1000) << '.' << char('0' + frac / 100) << char('0' + (frac / 10) % 10) << char('0' + frac % 10);
+}
+
+/*!
+ * \fn void writeChromeTrace(std::ostream & out) const
+ * \param output stream
+ * \brief writes the events in the Trace Event Format
+ *
+ * The output can be loaded in chrome://tracing or similar viewers.
+ */
+void Profiler::writeChromeTrace(std::ostream & out) const
+{
+  out << "{\"traceEvents\":[";
+
+  for (size_t i(0); i < m_events.size(); ++i)
+  {
+    const Event & e = m_events.at(i);
+
+    if (i > 0)
+      out << ",";
+
+    out << "{\"name\":";
+    write_json_string(out, e.name.empty() ? std::string(name(e.phase)) : e.name);
+    out << ",\"cat\":\"" << name(e.phase) << "\",\"ph\":\"X\"";
+    out << ",\"ts\":";
+    write_microseconds(out, e.start);
+    out << ",\"dur\":";
+    write_microseconds(out, e.duration);
+    out << ",\"pid\":1,\"tid\":1}";
+  }
+
+  out << "]}";
+}
+
+/*!
+ * \fn static const char* name(Phase p)
+ * \param phase
+ * \brief returns the name of a phase
+ */
+const char* Profiler::name(Phase p)
+{
+  static const char* names[PhaseCount] = {
+    "compilation",
+    "parsing",
+    "declarations",
+    "pending declarations",
+    "default arguments",
+    "function bodies",
+    "template instantiation",
+    "name lookup",
+  };
+
+  return names[static_cast<size_t>(p)];
+}
+
+/*!
+ * \fn static Profiler* current()
+ * \brief returns the profiler of the compile session running on the calling thread
+ *
+ * Returns nullptr if no session is running or if its profiler is disabled.
+ */
+Profiler* Profiler::current()
+{
+  return current_profiler;
+}
+
+void Profiler::setCurrent(Profiler* p)
+{
+  current_profiler = p;
+}
+
+Profiler::Timer::Timer(Phase p)
+  : m_profiler(current_profiler)
+  , m_phase(p)
+{
+  if (m_profiler)
+  {
+    m_profiler->m_depths[static_cast<size_t>(p)] += 1;
+    m_start = std::chrono::steady_clock::now();
+  }
+}
+
+Profiler::Timer::~Timer()
+{
+  if (!m_profiler)
+    return;
+
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+
+  const size_t index = static_cast<size_t>(m_phase);
+  Counter & counter = m_profiler->m_counters[index];
+  counter.count += 1;
+
+  if (--m_profiler->m_depths[index] == 0)
+    counter.time += duration;
+
+  if (m_phase == Phase::NameLookup)
+    return;
+
+  if (m_profiler->m_events.size() >= MaxEvents)
+  {
+    m_profiler->m_dropped_events += 1;
+    return;
+  }
+
+  Event e;
+  e.phase = m_phase;
+  e.name = std::move(m_name);
+  e.start = std::chrono::duration_cast<std::chrono::nanoseconds>(m_start - m_profiler->m_origin);
+  e.duration = duration;
+  m_profiler->m_events.push_back(std::move(e));
+}
+
+} // namespace compiler
+
+} // namespace script
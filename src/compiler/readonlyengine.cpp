@@ -0,0 +1,49 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "script/compiler/readonlyengine.h"
+
+namespace script
+{
+
+namespace compiler
+{
+
+static thread_local bool read_only_engine = false;
+
+ReadOnlyEngine::ReadOnlyEngine()
+  : m_previous(read_only_engine)
+{
+  read_only_engine = true;
+}
+
+ReadOnlyEngine::~ReadOnlyEngine()
+{
+  read_only_engine = m_previous;
+}
+
+/*!
+ * \fn static bool isActive()
+ * \brief returns whether the calling thread compiles against a read-only engine
+ */
+bool ReadOnlyEngine::isActive()
+{
+  return read_only_engine;
+}
+
+/*!
+ * \fn static void check()
+ * \brief throws DeferredCompilation if the engine is read-only for the calling thread
+ *
+ * This must be called before any modification is made.
+ */
+void ReadOnlyEngine::check()
+{
+  if (read_only_engine)
+    throw DeferredCompilation{};
+}
+
+} // namespace compiler
+
+} // namespace script
@@ -5,6 +5,7 @@
 #include "script/compiler/scopestatementprocessor.h"
 
 #include "script/compiler/diagnostichelper.h"
+#include "script/compiler/readonlyengine.h"
 
 #include <stdexcept>
 
@@ -21,6 +22,9 @@ void ScopeStatementProcessor::processUsingDirective(const std::shared_ptr<ast::U
   if (lookup.resultType() != NameLookup::NamespaceName)
     throw CompilationFailure{ CompilerError::InvalidNameInUsingDirective, errors::InvalidName{dstr(decl->namespace_name)} };
 
+  // the namespace is imported in the enclosing namespace scope, which may be shared
+  ReadOnlyEngine::check();
+
   scope_->inject(lookup.scopeResult());
 }
 
@@ -49,6 +53,8 @@ void ScopeStatementProcessor::processNamespaceAlias(const std::shared_ptr<ast::N
   std::reverse(nested.begin(), nested.end());
   NamespaceAlias alias{ name, std::move(nested) };
 
+  ReadOnlyEngine::check();
+
   scope_->inject(alias); /// TODO : this may throw and we should handle that
 }
 
@@ -11,6 +11,7 @@
 #include "script/compiler/defaultargumentprocessor.h"
 #include "script/compiler/diagnostichelper.h"
 #include "script/compiler/functioncompiler.h"
+#include "script/compiler/profiler.h"
 #include "script/compiler/templatedefinition.h"
 #include "script/compiler/templatespecialization.h"
 
@@ -36,6 +37,7 @@
 #include "script/functiontype.h"
 #include "script/literals.h"
 #include "script/private/script_p.h"
+#include "script/private/sourcefile_p.h"
 #include "script/private/template_p.h"
 #include "script/symbol.h"
 #include "script/templatebuilder.h"
@@ -57,6 +59,54 @@ static inline AccessSpecifier get_access_specifier(const std::shared_ptr<ast::Ac
   return AccessSpecifier::Public;
 }
 
+static std::string identifier_name(const std::shared_ptr<ast::Identifier> & id)
+{
+  return id == nullptr ? std::string() : id->source().toString();
+}
+
+/*
+ * Returns a short description of a declaration, used to name the events
+ * of the profiler.
+ */
+static std::string declaration_name(const std::shared_ptr<ast::Declaration> & decl)
+{
+  switch (decl->type())
+  {
+  case ast::NodeType::ClassDeclaration:
+    return "class " + identifier_name(decl->as<ast::ClassDecl>().name);
+  case ast::NodeType::EnumDeclaration:
+    return "enum " + identifier_name(decl->as<ast::EnumDeclaration>().name);
+  case ast::NodeType::Typedef:
+    return "typedef " + identifier_name(decl->as<ast::Typedef>().name);
+  case ast::NodeType::NamespaceDecl:
+    return "namespace " + identifier_name(decl->as<ast::NamespaceDeclaration>().namespace_name);
+  case ast::NodeType::FunctionDeclaration:
+  case ast::NodeType::ConstructorDeclaration:
+  case ast::NodeType::DestructorDeclaration:
+  case ast::NodeType::OperatorOverloadDeclaration:
+  case ast::NodeType::CastDeclaration:
+    return "function " + identifier_name(decl->as<ast::FunctionDecl>().name);
+  case ast::NodeType::VariableDeclaration:
+    return "variable " + identifier_name(decl->as<ast::VariableDecl>().name);
+  case ast::NodeType::TemplateDecl:
+    return "template " + declaration_name(decl->as<ast::TemplateDeclaration>().declaration);
+  default:
+    return decl->base_token().toString();
+  }
+}
+
+// attributes are kept after the ast is cleared, and so must be the arena 
+// of their nodes and the source of their tokens
+static void add_attributes(ScriptImpl& s, const void* elem, const AttributeVector& attrs)
+{
+  if (s.ast)
+    s.attributes_arena = s.ast->arena;
+
+  s.attributes_source = s.source;
+
+  s.attributes.add(elem, attrs);
+}
+
 ScriptCompiler::StateGuard::StateGuard(ScriptCompiler *c)
   : compiler(c)
   , script(c->mCurrentScript)
@@ -87,12 +137,34 @@ ScriptCompiler::~ScriptCompiler()
 
 }
 
+// sources larger than this are parsed on the compiler's threads
+static const size_t parallel_parsing_threshold = 512 * 1024;
+
+static std::shared_ptr<ast::AST> parse_script(SourceFile source, size_t threads)
+{
+  if (!source.isLoaded())
+    source.load();
+
+  // the source of a script outlives its compilation
+  source.impl()->copy_mapping();
+
+  if (threads > 1 && source.size() >= parallel_parsing_threshold)
+    return script::parser::parse(source, threads);
+
+  return script::parser::parse(source);
+}
+
 void ScriptCompiler::add(const Script & task)
 {
   try
   {
-    auto ast = script::parser::parse(task.source());
+    Profiler::Timer timer{ Profiler::Phase::Parsing };
+    if (timer.isActive())
+      timer.setName(task.path());
+
+    auto ast = parse_script(task.source(), compiler()->threadCount());
     task.impl()->ast = ast;
+    task.impl()->ast_arena = ast->arena;
     ast->script = task.impl();
   }
   catch (parser::SyntaxError & ex)
@@ -109,6 +181,46 @@ void ScriptCompiler::add(const Script & task)
   processOrCollectScriptDeclarations(task);
 }
 
+/*!
+ * \fn bool reschedule(const Script & s, const std::shared_ptr<ast::FunctionDecl> & decl)
+ * \param compiled script
+ * \param new declaration of a function of the script's root namespace
+ * \brief schedules the compilation of a new body for an existing function
+ *
+ * The function is found by comparing its name and prototype with the declaration.
+ * Returns false if no such function exists.
+ */
+bool ScriptCompiler::reschedule(const Script & s, const std::shared_ptr<ast::FunctionDecl> & decl)
+{
+  StateGuard guard{ this };
+
+  mCurrentScript = s;
+  mCurrentScope = Scope{ mCurrentScript };
+  mCurrentScope.merge(engine()->rootNamespace());
+
+  TranslationTarget target{ this, mCurrentScript, decl };
+
+  Symbol symbol{ mCurrentScope.symbol() };
+  std::string name = decl->name->as<ast::SimpleIdentifier>().getName();
+  FunctionBlueprint blueprint{ symbol, SymbolKind::Function, name };
+  function_processor_.generic_fill(blueprint, decl, mCurrentScope);
+
+  for (const Function & f : s.rootNamespace().functions())
+  {
+    if (f.name() != name || !(f.prototype() == blueprint.prototype()))
+      continue;
+
+    if (f.isDeleted() || f.impl()->is_native())
+      return false;
+
+    s.impl()->breakpoints_map.erase(f.impl());
+    mCompilationTasks.push(CompileFunctionTask{ f, decl, mCurrentScope });
+    return true;
+  }
+
+  return false;
+}
+
 Class ScriptCompiler::instantiate(const ClassTemplate & ct, const std::vector<TemplateArgument> & args)
 {
   TemplateSpecializationSelector selector;
@@ -181,6 +293,10 @@ void ScriptCompiler::processNext()
     auto task = mProcessingQueue.front();
     mProcessingQueue.pop();
 
+    Profiler::Timer timer{ Profiler::Phase::PendingDeclarations };
+    if (timer.isActive())
+      timer.setName(declaration_name(task.declaration));
+
     ScopeGuard guard{ mCurrentScope };
     mCurrentScope = task.scope;
 
@@ -282,6 +398,10 @@ void ScriptCompiler::processOrCollectDeclaration(const std::shared_ptr<ast::Decl
 
 void ScriptCompiler::processOrCollectDeclaration(const std::shared_ptr<ast::Declaration> & declaration)
 {
+  Profiler::Timer timer{ Profiler::Phase::Declarations };
+  if (timer.isActive())
+    timer.setName(declaration_name(declaration));
+
   TranslationTarget target{ this, declaration };
 
   switch (declaration->type())
@@ -371,6 +491,10 @@ void ScriptCompiler::processPendingDeclarations()
     auto task = mProcessingQueue.front();
     mProcessingQueue.pop();
 
+    Profiler::Timer timer{ Profiler::Phase::PendingDeclarations };
+    if (timer.isActive())
+      timer.setName(declaration_name(task.declaration));
+
     ScopeGuard guard{ mCurrentScope };
     mCurrentScope = task.scope;
 
@@ -418,7 +542,7 @@ void ScriptCompiler::processClassDeclaration(const std::shared_ptr<ast::ClassDec
 
   if (class_decl->attribute)
   {
-    mCurrentScript.impl()->attributes.add(cla.impl().get(), { class_decl->attribute->attribute });
+    add_attributes(*mCurrentScript.impl(), cla.impl().get(), { class_decl->attribute->attribute });
   }
 
   readClassContent(cla, class_decl);
@@ -486,7 +610,7 @@ void ScriptCompiler::processEnumDeclaration(const std::shared_ptr<ast::EnumDecla
 
   if (decl->attribute)
   {
-    mCurrentScript.impl()->attributes.add(e.impl().get(), { decl->attribute->attribute });
+    add_attributes(*mCurrentScript.impl(), e.impl().get(), { decl->attribute->attribute });
   }
 
   mCurrentScope.invalidateCache(Scope::InvalidateEnumCache);
@@ -810,11 +934,15 @@ void ScriptCompiler::processAttribute(Function& f, const std::vector<Attribute>&
   if (attributes.empty())
     return;
 
-  mCurrentScript.impl()->attributes.add(f.impl().get(), attributes);
+  add_attributes(*mCurrentScript.impl(), f.impl().get(), attributes);
 }
 
 void ScriptCompiler::processDefaultArguments(Function& f, const std::shared_ptr<ast::FunctionDecl>& decl)
 {
+  Profiler::Timer timer{ Profiler::Phase::DefaultArguments };
+  if (timer.isActive())
+    timer.setName(engine()->toString(f));
+
   ExpressionCompiler ec{ compiler(), currentScope() };
   DefaultArgumentVector defaultargs = script::compiler::process_default_arguments(ec, decl->params, f);
   f.script().impl()->defaultarguments.add(f.impl().get(), defaultargs);
@@ -889,6 +1017,7 @@ void ScriptCompiler::processClassTemplateDeclaration(const std::shared_ptr<ast::
 
   scp.invalidateCache(Scope::InvalidateTemplateCache);
 
+  ct.impl()->arena = currentAst()->arena;
   static_cast<ScriptClassTemplateBackend*>(ct.backend())->definition = TemplateDefinition::make(script(), decl);
 }
 
@@ -907,6 +1036,7 @@ void ScriptCompiler::processFunctionTemplateDeclaration(const std::shared_ptr<as
 
   scp.invalidateCache(Scope::InvalidateTemplateCache);
 
+  ft.impl()->arena = currentAst()->arena;
   static_cast<ScriptFunctionTemplateBackend*>(ft.backend())->definition = TemplateDefinition::make(script(), decl);
 }
 
@@ -951,7 +1081,7 @@ void ScriptCompiler::processClassTemplateFullSpecialization(const std::shared_pt
 
   readClassContent(result, classdecl);
 
-  ct.impl()->instances[args] = result;
+  ct.impl()->instances.insert(args, result);
 }
 
 void ScriptCompiler::processClassTemplatePartialSpecialization(const std::shared_ptr<ast::TemplateDeclaration> & decl, const std::shared_ptr<ast::ClassDecl> & classdecl)
@@ -969,6 +1099,7 @@ void ScriptCompiler::processClassTemplatePartialSpecialization(const std::shared
   std::vector<TemplateParameter> params = processTemplateParameters(decl);
 
   auto ps = std::make_shared<PartialTemplateSpecializationImpl>(ct, std::move(params), scp, engine(), scp.symbol().impl());
+  ps->arena = currentAst()->arena;
   ps->definition = TemplateDefinition::make(script(), decl);
 
   auto* back = dynamic_cast<ScriptClassTemplateBackend*>(ct.backend());
@@ -1019,7 +1150,7 @@ void ScriptCompiler::processFunctionTemplateFullSpecialization(const std::shared
   schedule(result, fundecl, scp);
 
   /// TODO : should this be done now or after full compilation ?
-  selection.first.impl()->instances[selection.second] = result;
+  selection.first.impl()->instances.insert(selection.second, result);
 }
 
 void ScriptCompiler::reprocess(ScopedDeclaration & func)
@@ -318,6 +318,14 @@ Value VariableProcessor::visit(const program::Copy & c)
   return manage(engine()->copy(val));
 }
 
+Value VariableProcessor::visit(const program::EnumAssignment & ea)
+{
+  Value lhs = eval(ea.lhs);
+  Value rhs = eval(ea.rhs);
+  script::get<Enumerator>(lhs) = script::get<Enumerator>(rhs);
+  return lhs;
+}
+
 Value VariableProcessor::visit(const program::FetchGlobal &)
 {
   throw CompilationFailure{ CompilerError::InvalidStaticInitialization };
@@ -388,6 +396,16 @@ Value VariableProcessor::visit(const program::StackValue &)
   throw CompilationFailure{ CompilerError::InvalidStaticInitialization };
 }
 
+Value VariableProcessor::visit(const program::StringConcatenation & sc)
+{
+  StringBuilder builder;
+
+  for (const auto & op : sc.operands)
+    builder.append(script::get<String>(eval(op)));
+
+  return manage(engine()->newString(builder.toString()));
+}
+
 Value VariableProcessor::visit(const program::VariableAccess & va)
 {
   /// TODO : detect circular references during initialization
@@ -10,6 +10,8 @@
 #include "script/class.h"
 #include "script/typesystem.h"
 
+#include "script/private/typesystem_p.h"
+
 #include "script/program/expression.h"
 
 #include <stdexcept>
@@ -436,18 +438,7 @@ StandardConversion StandardConversion::NotConvertible()
 }
 
 
-/*!
- * \fun static StandardConversion compute(const Type & src, const Type & dest, Engine *e)
- *
- * Computes, if possible, the standard conversion between \c src and \c dest; or returns 
- * \c{NotConvertible()}.
- *
- * Note that unlike the constructor taking two fundamental \t Type, this function 
- * can take arbitrary types (hence the last \t Engine parameter).
- *
- * This function takes into account the \c{const}-ness and \c{\&}.
- */
-StandardConversion StandardConversion::compute(const Type & src, const Type & dest, Engine *e)
+static StandardConversion compute_standard_conversion(const Type & src, const Type & dest, Engine *e)
 {
   if (dest.isReference() && src.isConst() && !dest.isConst())
     return StandardConversion::NotConvertible();
@@ -507,6 +498,34 @@ StandardConversion StandardConversion::compute(const Type & src, const Type & de
   return StandardConversion::NotConvertible();
 }
 
+/*!
+ * \fun static StandardConversion compute(const Type & src, const Type & dest, Engine *e)
+ *
+ * Computes, if possible, the standard conversion between \c src and \c dest; or returns 
+ * \c{NotConvertible()}.
+ *
+ * Note that unlike the constructor taking two fundamental \t Type, this function 
+ * can take arbitrary types (hence the last \t Engine parameter).
+ *
+ * This function takes into account the \c{const}-ness and \c{\&}.
+ */
+StandardConversion StandardConversion::compute(const Type & src, const Type & dest, Engine *e)
+{
+  if (!src.isObjectType() || !dest.isObjectType())
+    return compute_standard_conversion(src, dest, e);
+
+  // conversions between classes walk the inheritance chain, they are memoized
+  ConversionCache& cache = e->typeSystem()->impl()->conversions;
+  StandardConversion result;
+
+  if (cache.find(src, dest, result))
+    return result;
+
+  result = compute_standard_conversion(src, dest, e);
+  cache.insert(src, dest, result);
+  return result;
+}
+
 
 template<typename T>
 T fundamental_value_cast(const Value& v)
@@ -528,7 +547,7 @@ T fundamental_value_cast(const Value& v)
   }
 
   if (v.type().isEnumType())
-    return (T)v.toEnumerator().value();
+    return (T)(v.impl()->is_enumerator() ? script::get<Enumerator>(v).value() : v.impl()->get_cpp_enum_value());
 
   throw std::runtime_error{ "fundamental_value_cast : Implementation error" };
 }
@@ -762,7 +781,7 @@ Conversion Conversion::NotConvertible()
   return Conversion{ StandardConversion::NotConvertible() };
 }
 
-Conversion Conversion::compute(const Type & src, const Type & dest, Engine *engine, ConversionPolicy policy)
+static Conversion compute_conversion(const Type & src, const Type & dest, Engine *engine, Conversion::ConversionPolicy policy)
 {
   StandardConversion stdconv = StandardConversion::compute(src, dest, engine);
   if (stdconv != StandardConversion::NotConvertible())
@@ -794,6 +813,24 @@ Conversion Conversion::compute(const Type & src, const Type & dest, Engine *engi
   return Conversion::NotConvertible();
 }
 
+Conversion Conversion::compute(const Type & src, const Type & dest, Engine *engine, ConversionPolicy policy)
+{
+  if (!src.isObjectType() && !dest.isObjectType())
+    return compute_conversion(src, dest, engine, policy);
+
+  // user-defined conversions require going through the constructors and
+  // conversion functions of the classes, they are memoized
+  ConversionCache& cache = engine->typeSystem()->impl()->conversions;
+  Conversion result;
+
+  if (cache.find(src, dest, policy, result))
+    return result;
+
+  result = compute_conversion(src, dest, engine, policy);
+  cache.insert(src, dest, policy, result);
+  return result;
+}
+
 Conversion Conversion::compute(const std::shared_ptr<program::Expression> & expr, const Type & dest, Engine *engine)
 {
   if (expr->type() == Type::InitializerList)
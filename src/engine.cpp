@@ -27,6 +27,7 @@
 #include "script/scope.h"
 #include "script/script.h"
 #include "script/string.h"
+#include "script/stringview.h"
 #include "script/typesystem.h"
 #include "script/value.h"
 
@@ -37,6 +38,8 @@
 #include "script/compiler/compiler.h"
 #include "script/compiler/compilererrors.h"
 
+#include "script/ast/ast_p.h"
+
 #include "script/private/array_p.h"
 #include "script/private/builtinoperators.h"
 #include "script/private/class_p.h"
@@ -44,6 +47,7 @@
 #include "script/private/enum_p.h"
 #include "script/private/function_p.h"
 #include "script/private/lambda_p.h"
+#include "script/private/map_p.h"
 #include "script/private/namespace_p.h"
 #include "script/private/operator_p.h"
 #include "script/private/scope_p.h"
@@ -141,11 +145,31 @@ void EngineImpl::destroy(Namespace ns)
   impl->literal_operators.clear();
   impl->templates.clear(); /// TODO: clear the template instances
   impl->typedefs.clear();
+  impl->symbols.clear();
+
+  overload_resolution_cache.invalidate();
 
   impl->enclosing_symbol = std::weak_ptr<SymbolImpl>();
 }
 
 void EngineImpl::destroy(Script s)
+{
+  reset(s);
+
+  const int index = s.id();
+  this->scripts[index] = Script{};
+  while (!this->scripts.empty() && this->scripts.back().isNull())
+    this->scripts.pop_back();
+}
+
+/*!
+ * \fn void reset(Script s)
+ * \param input script
+ * \brief brings back a compiled script to the state it had before compilation
+ *
+ * Unlike destroy(), this does not unregister the script from the engine.
+ */
+void EngineImpl::reset(Script s)
 {
   auto impl = s.impl();
 
@@ -159,11 +183,23 @@ void EngineImpl::destroy(Script s)
 
   impl->globalNames.clear();
   impl->global_types.clear();
-
-  const int index = s.id();
-  this->scripts[index] = Script{};
-  while (!this->scripts.empty() && this->scripts.back().isNull())
-    this->scripts.pop_back();
+  impl->static_variables.clear();
+  impl->messages.clear();
+  impl->exports = Scope{};
+  impl->attributes.clear();
+  impl->attributes_arena = nullptr;
+  impl->attributes_source = SourceFile{};
+  impl->defaultarguments.clear();
+  impl->breakpoints_map.clear();
+  impl->deferred_functions.clear();
+  impl->deferred_functions_index.clear();
+  impl->failed_functions.clear();
+  impl->deferred_retention = RetentionPolicy::KeepAll;
+  // released last, the other members may reference nodes of the ast
+  impl->ast = nullptr;
+  impl->ast_arena.reset();
+  impl->program = Function{};
+  impl->loaded = false;
 }
 
 namespace errors
@@ -276,8 +312,15 @@ void Engine::setup()
   Class string = ClassBuilder(Symbol(d->rootNamespace), StringBackend::class_name()).setId(Type::String).get();
   StringBackend::register_string_type(string);
 
+  Class string_builder = ClassBuilder(Symbol(d->rootNamespace), "StringBuilder").setId(registerType<StringBuilder>("StringBuilder").data()).get();
+  StringBackend::register_string_builder_type(string_builder);
+
   d->templates.array = ArrayImpl::register_array_template(this);
   d->templates.initializer_list = register_initialize_list_template(this);
+  d->templates.map = MapImpl::register_map_template(this);
+
+  Class string_view = ClassBuilder(Symbol(d->rootNamespace), "StringView").setId(registerType<StringView>("StringView").data()).get();
+  StringBackend::register_string_view_type(string_view);
 
   d->compiler = std::unique_ptr<compiler::Compiler>(new compiler::Compiler{ this });
 
@@ -305,6 +348,7 @@ void Engine::tearDown()
   d->templates.dict.clear();
   d->templates.array = ClassTemplate();
   d->templates.initializer_list = ClassTemplate();
+  d->templates.map = ClassTemplate();
 
   if(!d->context.isNull())
     d->context.clear();
@@ -621,6 +665,10 @@ Value Engine::copy(const Value & val)
   else if (val.type().isEnumType())
   {
     Enum enm = typeSystem()->getEnum(val.type());
+
+    if (enm.impl()->intrinsic)
+      return Value(new EnumeratorValue(script::get<Enumerator>(val)));
+
     return enm.impl()->copy.invoke({ val });
   }
   else if (val.type().isObjectType())
@@ -717,15 +765,69 @@ Script Engine::newScript(const SourceFile & source)
 }
 
 /*!
- * \fn bool compile(Script s, CompileMode mode)
+ * \fn bool compile(Script s, CompileMode mode, RetentionPolicy policy)
  * \param input script
  * \param compilation mode
+ * \param what should be kept in memory after a successful compilation
  * \brief Compiles a script.
  *
+ * The ast and the source are always kept if the script contains templates,
+ * as they are needed for instantiating them.
+ * The source is also kept if the script has attributes.
+ * If the compilation of some functions was deferred, they are released 
+ * once all these functions are compiled.
  */
-bool Engine::compile(Script s, CompileMode mode)
+bool Engine::compile(Script s, CompileMode mode, RetentionPolicy policy)
 {
-  return compiler()->compile(s, mode);
+  if (!compiler()->compile(s, mode))
+    return false;
+
+  s.impl()->apply_retention_policy(policy);
+  return true;
+}
+
+/*!
+ * \fn bool recompile(Script s, const SourceFile& src, CompileMode mode)
+ * \param compiled script
+ * \param new version of the script's source
+ * \param compilation mode
+ * \brief Recompiles a script whose source changed.
+ *
+ * When the changes are limited to the bodies of functions of the script's 
+ * root namespace, only these functions are reparsed and recompiled; the 
+ * Function objects (and therefore the program of their callers) are preserved.
+ * Any other change triggers a full recompilation of the script.
+ *
+ * \a src must be a different SourceFile than the one currently used by the script.
+ * The ast of the script is not kept after an incremental recompilation.
+ */
+bool Engine::recompile(Script s, const SourceFile& src, CompileMode mode)
+{
+  return compiler()->recompile(s, src, mode);
+}
+
+/*!
+ * \fn RetainedMemory retainedMemory(const Script& s) const
+ * \param input script
+ * \brief Returns the memory used by the source and the ast of a script.
+ *
+ * The size of the ast is the memory reserved by the arena in which 
+ * its nodes are allocated.
+ * Some nodes, such as the attributes or the definition of templates, 
+ * are kept after the ast is destroyed; the arena is then reported for 
+ * as long as it is alive.
+ */
+Engine::RetainedMemory Engine::retainedMemory(const Script& s) const
+{
+  RetainedMemory result;
+
+  if (s.source().isLoaded())
+    result.source = s.source().size();
+
+  if (std::shared_ptr<ast::Arena> arena = s.impl()->ast_arena.lock())
+    result.ast = arena->bytesReserved();
+
+  return result;
 }
 
 /*!
@@ -22,6 +22,7 @@ EnumImpl::EnumImpl(int i, const std::string & n, Engine *e)
   , id(i)
   , name(n)
   , enumClass(false)
+  , intrinsic(false)
 {
 
 }
@@ -63,6 +63,7 @@ Enum EnumBuilder::get()
   auto impl = std::make_shared<EnumImpl>(0, std::move(name), symbol.engine());
   impl->enclosing_symbol = symbol.impl();
   impl->enumClass = is_enum_class;
+  impl->intrinsic = from_int_callback == nullptr && copy_callback == nullptr && assignment_callback == nullptr;
 
   Enum result{ impl };
   
@@ -61,13 +61,7 @@ FunctionTemplateNativeBackend* FunctionTemplate::backend() const
 
 bool FunctionTemplate::hasInstance(const std::vector<TemplateArgument> & args, Function *value) const
 {
-  auto d = impl();
-  auto it = d->instances.find(args);
-  if (it == d->instances.end())
-    return false;
-  if (value != nullptr)
-    *value = it->second;
-  return true;
+  return impl()->instances.find(args, value);
 }
 
 Function FunctionTemplate::getInstance(const std::vector<TemplateArgument> & args)
@@ -82,7 +76,7 @@ Function FunctionTemplate::getInstance(const std::vector<TemplateArgument> & arg
   ret = ftp.deduce_substitute(*this, args, {});
   ftp.instantiate(ret);
 
-  d->instances[args] = ret;
+  d->instances.insert(args, ret);
   return ret;
 }
 
@@ -93,14 +87,14 @@ Function FunctionTemplate::addSpecialization(const std::vector<TemplateArgument>
   Function ret{ impl };
   if (ret.isNull())
     return ret;
-  d->instances[args] = ret;
+  d->instances.insert(args, ret);
   return ret;
 }
 
 const std::map<std::vector<TemplateArgument>, Function, TemplateArgumentComparison> & FunctionTemplate::instances() const
 {
   auto d = impl();
-  return d->instances;
+  return d->instances.map();
 }
 
 std::shared_ptr<FunctionTemplateImpl> FunctionTemplate::impl() const
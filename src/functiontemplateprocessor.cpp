@@ -18,6 +18,8 @@
 #include "script/compiler/compilererrors.h"
 #include "script/compiler/functionprocessor.h"
 #include "script/compiler/nameresolver.h"
+#include "script/compiler/profiler.h"
+#include "script/compiler/readonlyengine.h"
 
 #include <algorithm>
 
@@ -49,9 +51,15 @@ diagnostic::DiagnosticMessage FunctionTemplateProcessor::emitDiagnostic() const
 
 void FunctionTemplateProcessor::instantiate(Function & f)
 {
+  compiler::ReadOnlyEngine::check();
+
   FunctionTemplate ft = f.instanceOf();
   const std::vector<TemplateArgument> & targs = f.arguments();
 
+  compiler::Profiler::Timer timer{ compiler::Profiler::Phase::TemplateInstantiation };
+  if (timer.isActive())
+    timer.setName(ft.engine()->toString(f));
+
   auto result = ft.backend()->instantiate(f);
   
   if(result.first)
@@ -73,13 +81,17 @@ void FunctionTemplateProcessor::instantiate(Function & f)
   //  compiler->instantiate(decl, f, ft.argumentScope(f.arguments()));
   //}
 
-  ft.impl()->instances[targs] = f;
+  ft.impl()->instances.insert(targs, f);
 
   f.impl()->complete_instantiation();
 }
 
 Function FunctionTemplateProcessor::deduce_substitute(const FunctionTemplate & ft, const std::vector<TemplateArgument> & args, const std::vector<Type> & types)
 {
+  // deduction and substitution are done by the backend of the template, 
+  // which may use the compiler of the engine
+  compiler::ReadOnlyEngine::check();
+
   const std::vector<TemplateArgument> *template_args = &args;
   std::vector<TemplateArgument> targs_copy;
 
@@ -93,8 +93,9 @@ Stack::iterator StackView::end() const
 
 
 FunctionCall::FunctionCall()
-  : mStackIndex(0)
-  , flags(0)
+  : mCallee(nullptr)
+  , mStackIndex(0)
+  , mArgc(0)
   , ec(nullptr)
 {
 
@@ -113,7 +114,7 @@ FunctionCall* FunctionCall::caller() const
 void FunctionCall::setReturnValue(const Value & val)
 {
   this->ec->stack[this->mStackIndex] = val;
-  this->flags = ReturnFlag;
+  this->ec->mFlags = ReturnFlag;
 }
 
 Value& FunctionCall::returnValue()
@@ -158,17 +159,17 @@ size_t FunctionCall::depth() const
 
 void FunctionCall::setBreakFlag()
 {
-  this->flags = BreakFlag;
+  this->ec->mFlags = BreakFlag;
 }
 
 void FunctionCall::setContinueFlag()
 {
-  this->flags = ContinueFlag;
+  this->ec->mFlags = ContinueFlag;
 }
 
 void FunctionCall::clearFlags()
 {
-  this->flags = 0;
+  this->ec->mFlags = NoFlags;
 }
 
 
@@ -195,9 +196,9 @@ FunctionCall * Callstack::push(const Function & f, size_t stackOffset)
     throw std::runtime_error{ "Callstack overflow" };
 
   FunctionCall *ret = std::addressof(mData[mSize++]);
-  ret->mCallee = f;
+  ret->mCallee = &f;
   ret->mStackIndex = stackOffset;
-  ret->flags = FunctionCall::NoFlags;
+  ret->mArgc = f.prototype().count();
   return ret;
 }
 
@@ -238,7 +239,11 @@ ExecutionContext::ExecutionContext(Engine *e, size_t stackSize, size_t callStack
   : engine(e)
   , stack(stackSize)
   , callstack(callStackSize)
+  , mFlags(FunctionCall::NoFlags)
 {
+  for (size_t i(0); i < callStackSize; ++i)
+    callstack[i]->ec = this;
+
   /// TODO: size must never exceed initial reserved amount, check for that
   // (otherwise some instances will become invalid)
   initializer_list_buffer.reserve(256);
@@ -251,42 +256,35 @@ ExecutionContext::~ExecutionContext()
 
 void ExecutionContext::push(const Function & f, const Value *obj, const Value *begin, const Value *end)
 {
-  FunctionCall *fc = this->callstack.push(f, this->stack.size);
+  this->callstack.push(f, this->stack.size);
   this->stack[this->stack.size++] = Value::Void;
   if (obj != nullptr)
     this->stack[this->stack.size++] = *obj;
   for (auto it = begin; it != end; ++it)
     this->stack[this->stack.size++] = *it;
-  fc->ec = this;
+  mFlags = FunctionCall::NoFlags;
 }
 
 void ExecutionContext::push(const Function & f, size_t sp)
 {
-  FunctionCall* fc = this->callstack.push(f, sp);
-  fc->ec = this;
+  this->callstack.push(f, sp);
+  mFlags = FunctionCall::NoFlags;
 }
 
 Value ExecutionContext::pop()
 {
   FunctionCall *fc = this->callstack.top();
-  for (int i = 0; i < fc->argc(); ++i)
+  for (size_t i = 0; i < fc->argc(); ++i)
     this->stack.pop();
   this->callstack.pop();
 
+  // calls are only made while the caller has no flags set
+  mFlags = FunctionCall::NoFlags;
+
   Value ret = this->stack.pop();
   return ret;
 }
 
-int ExecutionContext::flags() const
-{
-  return this->callstack.top()->flags;
-}
-
-void ExecutionContext::clearFlags()
-{
-  this->callstack.top()->clearFlags();
-}
-
 } // namespace interpreter
 
 } // namespace script
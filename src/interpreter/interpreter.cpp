@@ -9,7 +9,10 @@
 #include "script/engine.h"
 #include "script/private/engine_p.h"
 
+#include "script/compiler/compiler.h"
+
 #include "script/context.h"
+#include "script/functioncreator.h"
 #include "script/initializerlist.h"
 #include "script/object.h"
 #include "script/script.h"
@@ -179,10 +182,27 @@ void Interpreter::invoke(const Function & f)
   } 
   else 
   {
+    if (impl->body() == FunctionCreator::compile_later())
+      compile_deferred(f);
+
     exec(f.program());
   }
 }
 
+void Interpreter::compile_deferred(const Function & f)
+{
+  if (mEngine->compiler()->compile(f))
+    return;
+
+  const auto & failed = f.script().impl()->failed_functions;
+  auto it = failed.find(f.impl().get());
+
+  if (it == failed.end() || it->second.severity() != diagnostic::Severity::Error)
+    throw RuntimeError{ "could not compile function" };
+
+  throw RuntimeError{ it->second.to_string() };
+}
+
 void Interpreter::visit(const program::BreakStatement & bs) 
 {
   for (const auto & s : bs.destruction)
@@ -423,6 +443,14 @@ Value Interpreter::visit(const program::Copy & copy)
   return ret;
 }
 
+Value Interpreter::visit(const program::EnumAssignment & ea)
+{
+  Value lhs = inner_eval(ea.lhs);
+  Value rhs = inner_eval(ea.rhs);
+  script::get<Enumerator>(lhs) = script::get<Enumerator>(rhs);
+  return lhs;
+}
+
 Value Interpreter::visit(const program::FetchGlobal & fetch)
 {
   const Script & script = mExecutionContext->engine->implementation()->scripts.at(fetch.script_index);
@@ -532,6 +560,28 @@ Value Interpreter::visit(const program::StackValue & sv)
   return mExecutionContext->stack[sv.stackIndex + mExecutionContext->callstack.top()->stackOffset()];
 }
 
+Value Interpreter::visit(const program::StringConcatenation & sc)
+{
+  std::vector<Value> operands;
+  operands.reserve(sc.operands.size());
+
+  size_t length = 0;
+
+  for (const auto & op : sc.operands)
+  {
+    operands.push_back(inner_eval(op));
+    length += script::get<String>(operands.back()).size();
+  }
+
+  StringBuilder builder;
+  builder.reserve(length);
+
+  for (const Value & v : operands)
+    builder.append(script::get<String>(v));
+
+  return Value(new CppValue<String>(mEngine, Type::String, builder.release()));
+}
+
 Value Interpreter::visit(const program::VariableAccess & va)
 {
   return va.value;
@@ -0,0 +1,570 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "script/maptemplate.h"
+
+#include "script/engine.h"
+#include "script/classtemplateinstancebuilder.h"
+#include "script/functionbuilder.h"
+#include "script/namelookup.h"
+#include "script/overloadresolution.h"
+#include "script/template.h"
+#include "script/templatebuilder.h"
+#include "script/typesystem.h"
+
+#include "script/private/engine_p.h"
+#include "script/private/map_p.h"
+#include "script/private/value_p.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace script
+{
+
+namespace callbacks
+{
+
+namespace map
+{
+
+static std::shared_ptr<SharedMapData> get_shared_data(FunctionCall *c)
+{
+  return std::dynamic_pointer_cast<SharedMapData>(c->callee().memberOf().data());
+}
+
+static MapImpl& self(FunctionCall *c)
+{
+  return script::get<MapImpl>(c->arg(0));
+}
+
+// Map<K, V>();
+Value default_ctor(FunctionCall *c)
+{
+  c->thisObject() = Value(new CppValue<MapImpl>(c->engine(), c->callee().memberOf().id(), get_shared_data(c), c->engine()));
+  return c->thisObject();
+}
+
+// Map<K, V>(const Map<K, V> & other);
+Value copy_ctor(FunctionCall *c)
+{
+  const MapImpl& other = script::get<MapImpl>(c->arg(1));
+  c->thisObject() = Value(new CppValue<MapImpl>(c->engine(), c->callee().memberOf().id(), other));
+  return c->thisObject();
+}
+
+// ~Map<K, V>();
+Value dtor(FunctionCall *c)
+{
+  self(c).clear();
+  return Value::Void;
+}
+
+// void Map<K, V>::clear();
+Value clear(FunctionCall *c)
+{
+  self(c).clear();
+  return Value::Void;
+}
+
+// bool Map<K, V>::contains(const K & key) const;
+Value contains(FunctionCall *c)
+{
+  return c->engine()->newBool(self(c).find(c->arg(1)) != nullptr);
+}
+
+// bool Map<K, V>::empty() const;
+Value empty(FunctionCall *c)
+{
+  return c->engine()->newBool(self(c).size == 0);
+}
+
+// bool Map<K, V>::insert(const K & key, const V & value);
+Value insert(FunctionCall *c)
+{
+  return c->engine()->newBool(self(c).insert(c->arg(1), c->arg(2)));
+}
+
+// bool Map<K, V>::remove(const K & key);
+Value remove(FunctionCall *c)
+{
+  return c->engine()->newBool(self(c).remove(c->arg(1)));
+}
+
+// void Map<K, V>::reserve(int n);
+Value reserve(FunctionCall *c)
+{
+  const int n = c->arg(1).toInt();
+
+  if (n > 0)
+    self(c).reserve(static_cast<size_t>(n));
+
+  return Value::Void;
+}
+
+// int Map<K, V>::size() const;
+Value size(FunctionCall *c)
+{
+  return c->engine()->newInt(static_cast<int>(self(c).size));
+}
+
+// V & Map<K, V>::operator[](const K & key);
+Value subscript(FunctionCall *c)
+{
+  return self(c).get(c->arg(1));
+}
+
+// Map<K, V> & Map<K, V>::operator=(const Map<K, V> & other);
+Value assign(FunctionCall *c)
+{
+  MapImpl& other = script::get<MapImpl>(c->arg(1));
+
+  if (&other != &self(c))
+    self(c).assign(other);
+
+  return c->arg(0);
+}
+
+} // namespace map
+
+} // namespace callbacks
+
+
+static Function find_hash_function(Class cla)
+{
+  for (; !cla.isNull(); cla = cla.parent())
+  {
+    for (const Function& f : cla.memberFunctions())
+    {
+      if (f.name() == "hash" && f.isConst() && f.prototype().count() == 1 && f.returnType().baseType() == Type::Int)
+        return f;
+    }
+  }
+
+  return Function();
+}
+
+static Function find_equal_operator(Class cla)
+{
+  const Type arg = Type::cref(cla.id());
+  std::vector<Function> candidates = NameLookup::resolve(EqualOperator, arg, arg, Scope(cla.enclosingNamespace()));
+  OverloadResolution::Candidate resol = resolve_overloads(candidates, std::vector<Type>{ arg, arg });
+  return resol ? resol.function : Function();
+}
+
+// Class keys are hashed and compared using functions provided by the user,
+// these may be declared after the first use of the Map and are therefore
+// looked up again when a Map is used.
+static void resolve_key_functions(MapData& data, Engine* e)
+{
+  Class cla = e->typeSystem()->getClass(data.keyType);
+
+  if (data.hash.isNull())
+    data.hash = find_hash_function(cla);
+
+  if (data.equal.isNull())
+    data.equal = find_equal_operator(cla);
+}
+
+static bool is_native_key(const Type& t)
+{
+  return t.isFundamentalType() || t.isEnumType() || t.baseType() == Type::String;
+}
+
+static int get_enum_value(const Value& val)
+{
+  return val.impl()->is_cpp_enum() ? val.impl()->get_cpp_enum_value() : script::get<Enumerator>(val).value();
+}
+
+// finalizer of the splitmix64 generator, spreads sequential keys
+// over the whole table
+static size_t mix(uint64 h)
+{
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return static_cast<size_t>(h);
+}
+
+Class MapTemplate::instantiate(ClassTemplateInstanceBuilder& builder)
+{
+  const auto& arguments = builder.arguments();
+
+  if (arguments.size() != 2)
+    throw TemplateInstantiationError{ TemplateInstantiationError::InvalidArgumentCount };
+
+  if (arguments.at(0).kind != TemplateArgument::TypeArgument || arguments.at(1).kind != TemplateArgument::TypeArgument)
+    throw TemplateInstantiationError{ TemplateInstantiationError::ArgumentMustBeAType };
+
+  const Type key_type = arguments.at(0).type.baseType();
+  const Type value_type = arguments.at(1).type.baseType();
+
+  if (value_type.isEnumType())
+    throw TemplateInstantiationError{ TemplateInstantiationError::ArgumentCannotBeAnEnumeration };
+
+  Engine * e = builder.getTemplate().engine();
+  MapData data;
+  data.keyType = key_type;
+  data.valueType = value_type;
+
+  if (key_type.isObjectType())
+  {
+    Class key_class = e->typeSystem()->getClass(key_type);
+    data.keyCopyConstructor = key_class.copyConstructor();
+    data.keyDestructor = key_class.destructor();
+
+    if (data.keyCopyConstructor.isNull())
+      throw TemplateInstantiationError{ TemplateInstantiationError::TypeMustBeCopyConstructible };
+    if (data.keyDestructor.isNull())
+      throw TemplateInstantiationError{ TemplateInstantiationError::TypeMustBeDestructible };
+
+    if (!is_native_key(key_type))
+      resolve_key_functions(data, e);
+  }
+  else if (!is_native_key(key_type))
+  {
+    throw TemplateInstantiationError{ TemplateInstantiationError::TypeMustBeHashable };
+  }
+
+  if (value_type.isObjectType())
+  {
+    Class value_class = e->typeSystem()->getClass(value_type);
+    data.valueConstructor = value_class.defaultConstructor();
+    data.valueCopyConstructor = value_class.copyConstructor();
+    data.valueDestructor = value_class.destructor();
+
+    if (data.valueConstructor.isNull())
+      throw TemplateInstantiationError{ TemplateInstantiationError::TypeMustBeDefaultConstructible };
+    if (data.valueCopyConstructor.isNull())
+      throw TemplateInstantiationError{ TemplateInstantiationError::TypeMustBeCopyConstructible };
+    if (data.valueDestructor.isNull())
+      throw TemplateInstantiationError{ TemplateInstantiationError::TypeMustBeDestructible };
+  }
+
+  builder.name = std::string("Map<") + e->typeSystem()->typeName(key_type) + std::string(", ")
+    + e->typeSystem()->typeName(value_type) + std::string(">");
+
+  auto shared_data = std::make_shared<SharedMapData>(data);
+  builder.setData(shared_data);
+
+  Class map_class = builder.get();
+  shared_data->data.typeId = map_class.id();
+  Type map_type = map_class.id();
+
+  FunctionBuilder::Constructor(map_class).setCallback(callbacks::map::default_ctor).create();
+
+  FunctionBuilder::Constructor(map_class).setCallback(callbacks::map::copy_ctor).params(Type::cref(map_type)).create();
+
+  FunctionBuilder::Destructor(map_class).setCallback(callbacks::map::dtor).create();
+
+  FunctionBuilder::Fun(map_class, "clear").setCallback(callbacks::map::clear).create();
+
+  FunctionBuilder::Fun(map_class, "contains").setCallback(callbacks::map::contains)
+    .setConst().returns(Type::Boolean).params(Type::cref(key_type)).create();
+
+  FunctionBuilder::Fun(map_class, "empty").setCallback(callbacks::map::empty)
+    .setConst().returns(Type::Boolean).create();
+
+  FunctionBuilder::Fun(map_class, "insert").setCallback(callbacks::map::insert)
+    .returns(Type::Boolean).params(Type::cref(key_type), Type::cref(value_type)).create();
+
+  FunctionBuilder::Fun(map_class, "remove").setCallback(callbacks::map::remove)
+    .returns(Type::Boolean).params(Type::cref(key_type)).create();
+
+  FunctionBuilder::Fun(map_class, "reserve").setCallback(callbacks::map::reserve)
+    .params(Type::Int).create();
+
+  FunctionBuilder::Fun(map_class, "size").setCallback(callbacks::map::size)
+    .setConst().returns(Type::Int).create();
+
+  FunctionBuilder::Op(map_class, AssignmentOperator).setCallback(callbacks::map::assign)
+    .returns(Type::ref(map_type))
+    .params(Type::cref(map_type)).create();
+
+  FunctionBuilder::Op(map_class, SubscriptOperator).setCallback(callbacks::map::subscript)
+    .returns(Type::ref(value_type))
+    .params(Type::cref(key_type)).create();
+
+  return map_class;
+}
+
+ClassTemplate MapImpl::register_map_template(Engine *e)
+{
+  Namespace root = e->rootNamespace();
+
+  std::vector<TemplateParameter> params{
+    TemplateParameter{ TemplateParameter::TypeParameter{}, "K" },
+    TemplateParameter{ TemplateParameter::TypeParameter{}, "V" },
+  };
+
+  ClassTemplate map_template = ClassTemplateBuilder(Symbol(root), "Map")
+    .setParams(std::move(params))
+    .setScope(Scope{ root })
+    .withBackend<MapTemplate>()
+    .get();
+
+  return map_template;
+}
+
+
+SharedMapData::SharedMapData(const MapData & d)
+  : data(d)
+{
+
+}
+
+MapImpl::MapImpl(const std::shared_ptr<SharedMapData> & d, Engine *e)
+  : shared_data(d)
+  , engine(e)
+  , size(0)
+{
+
+}
+
+MapImpl::MapImpl(const MapImpl & other)
+  : shared_data(other.shared_data)
+  , engine(other.engine)
+  , size(0)
+{
+  assign(other);
+}
+
+size_t MapImpl::hash(const Value & key) const
+{
+  const Type t = data().keyType;
+
+  switch (t.data())
+  {
+  case Type::Boolean:
+    return mix(key.toBool() ? 1 : 0);
+  case Type::Char:
+    return mix(static_cast<uint64>(key.toChar()));
+  case Type::Int:
+    return mix(static_cast<uint64>(key.toInt()));
+  case Type::Float:
+    return mix(std::hash<float>()(key.toFloat()));
+  case Type::Double:
+    return mix(std::hash<double>()(key.toDouble()));
+  case Type::String:
+    return mix(std::hash<String>()(script::get<String>(key)));
+  default:
+    break;
+  }
+
+  if (t.isEnumType())
+    return mix(static_cast<uint64>(get_enum_value(key)));
+
+  if (data().hash.isNull())
+  {
+    resolve_key_functions(shared_data->data, engine);
+
+    if (data().hash.isNull())
+      throw RuntimeError{ "Map key type has no 'int hash() const' member function" };
+  }
+
+  return mix(static_cast<uint64>(data().hash.invoke({ key }).toInt()));
+}
+
+bool MapImpl::equal(const Value & a, const Value & b) const
+{
+  const Type t = data().keyType;
+
+  switch (t.data())
+  {
+  case Type::Boolean:
+    return a.toBool() == b.toBool();
+  case Type::Char:
+    return a.toChar() == b.toChar();
+  case Type::Int:
+    return a.toInt() == b.toInt();
+  case Type::Float:
+    return a.toFloat() == b.toFloat();
+  case Type::Double:
+    return a.toDouble() == b.toDouble();
+  case Type::String:
+    return script::get<String>(a) == script::get<String>(b);
+  default:
+    break;
+  }
+
+  if (t.isEnumType())
+    return get_enum_value(a) == get_enum_value(b);
+
+  if (data().equal.isNull())
+  {
+    resolve_key_functions(shared_data->data, engine);
+
+    if (data().equal.isNull())
+      throw RuntimeError{ "Map key type has no operator==" };
+  }
+
+  return data().equal.invoke({ a, b }).toBool();
+}
+
+size_t MapImpl::probe(const Value & key, size_t h) const
+{
+  const size_t mask = slots.size() - 1;
+  size_t i = h & mask;
+
+  while (slots[i].used && !(slots[i].hash == h && equal(slots[i].key, key)))
+    i = (i + 1) & mask;
+
+  return i;
+}
+
+MapImpl::Slot* MapImpl::find(const Value & key)
+{
+  if (size == 0)
+    return nullptr;
+
+  Slot& s = slots[probe(key, hash(key))];
+  return s.used ? &s : nullptr;
+}
+
+Value& MapImpl::get(const Value & key)
+{
+  reserve(size + 1);
+
+  const size_t h = hash(key);
+  Slot& s = slots[probe(key, h)];
+
+  if (s.used)
+    return s.value;
+
+  s.key = engine->implementation()->copy(key, data().keyCopyConstructor);
+  s.value = engine->implementation()->default_construct(data().valueType, data().valueConstructor);
+  s.hash = h;
+  s.used = true;
+  ++size;
+
+  return s.value;
+}
+
+bool MapImpl::insert(const Value & key, const Value & value)
+{
+  reserve(size + 1);
+
+  const size_t h = hash(key);
+  Slot& s = slots[probe(key, h)];
+
+  if (s.used)
+    return false;
+
+  s.key = engine->implementation()->copy(key, data().keyCopyConstructor);
+  s.value = engine->implementation()->copy(value, data().valueCopyConstructor);
+  s.hash = h;
+  s.used = true;
+  ++size;
+
+  return true;
+}
+
+bool MapImpl::remove(const Value & key)
+{
+  if (size == 0)
+    return false;
+
+  const size_t mask = slots.size() - 1;
+  size_t i = probe(key, hash(key));
+
+  if (!slots[i].used)
+    return false;
+
+  engine->destroy(slots[i].key);
+  engine->destroy(slots[i].value);
+  --size;
+
+  // backward-shift the following entries of the cluster
+  for (size_t j = (i + 1) & mask; slots[j].used; j = (j + 1) & mask)
+  {
+    const size_t k = slots[j].hash & mask;
+    const bool in_place = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+
+    if (in_place)
+      continue;
+
+    slots[i] = std::move(slots[j]);
+    i = j;
+  }
+
+  slots[i] = Slot();
+
+  return true;
+}
+
+void MapImpl::reserve(size_t n)
+{
+  // keep the load factor below 3/4
+  if (4 * n <= 3 * slots.size())
+    return;
+
+  size_t capacity = std::max<size_t>(8, slots.size());
+  while (4 * n > 3 * capacity)
+    capacity *= 2;
+
+  rehash(capacity);
+}
+
+void MapImpl::clear()
+{
+  for (Slot& s : slots)
+  {
+    if (!s.used)
+      continue;
+
+    engine->destroy(s.key);
+    engine->destroy(s.value);
+    s = Slot();
+  }
+
+  size = 0;
+}
+
+void MapImpl::assign(const MapImpl & other)
+{
+  clear();
+
+  slots.clear();
+  slots.resize(other.slots.size());
+
+  for (size_t i(0); i < other.slots.size(); ++i)
+  {
+    const Slot& src = other.slots.at(i);
+
+    if (!src.used)
+      continue;
+
+    Slot& s = slots[i];
+    s.key = engine->implementation()->copy(src.key, data().keyCopyConstructor);
+    s.value = engine->implementation()->copy(src.value, data().valueCopyConstructor);
+    s.hash = src.hash;
+    s.used = true;
+  }
+
+  size = other.size;
+}
+
+void MapImpl::rehash(size_t capacity)
+{
+  std::vector<Slot> old{ std::move(slots) };
+  slots = std::vector<Slot>(capacity);
+
+  const size_t mask = capacity - 1;
+
+  for (Slot& s : old)
+  {
+    if (!s.used)
+      continue;
+
+    size_t i = s.hash & mask;
+    while (slots[i].used)
+      i = (i + 1) & mask;
+
+    slots[i] = std::move(s);
+  }
+}
+
+} // namespace script
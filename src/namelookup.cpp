@@ -7,37 +7,24 @@
 
 #include "script/datamember.h"
 #include "script/engine.h"
+#include "script/private/class_p.h"
+#include "script/private/namespace_p.h"
 #include "script/private/scope_p.h"
 #include "script/functiontype.h"
 #include "script/staticdatamember.h"
 #include "script/templateargumentprocessor.h"
 #include "script/typesystem.h"
 
+#include "script/compiler/profiler.h"
+
 #include "script/parser/parser.h"
 
 #include "script/program/expression.h"
 
-namespace script
-{
+#include <algorithm>
 
-class ScopeParentGuard
+namespace script
 {
-  std::shared_ptr<ScopeImpl> guarded_scope;
-  std::shared_ptr<ScopeImpl> parent_value;
-public:
-  explicit ScopeParentGuard(const Scope & s)
-    : guarded_scope(s.impl()),
-      parent_value(guarded_scope->parent)
-  {
-
-  }
-
-  ~ScopeParentGuard()
-  {
-    guarded_scope->parent = parent_value;
-  }
-};
-
 
 NameLookupImpl::NameLookupImpl()
   : dataMemberIndex(-1)
@@ -208,6 +195,8 @@ const Class & NameLookup::memberOf() const
 
 NameLookup NameLookup::resolve(const std::shared_ptr<ast::Identifier> & name, const Scope & scope)
 {
+  compiler::Profiler::Timer timer{ compiler::Profiler::Phase::NameLookup };
+
   auto result = std::make_shared<NameLookupImpl>();
   result->identifier = name;
   result->scope = scope;
@@ -237,6 +226,8 @@ NameLookup NameLookup::resolve(const std::string & name, const Scope & scope)
     return NameLookup::resolve(id, scope);
   }
 
+  compiler::Profiler::Timer timer{ compiler::Profiler::Phase::NameLookup };
+
   std::shared_ptr<NameLookupImpl> result = std::make_shared<NameLookupImpl>();
   result->scope = scope;
 
@@ -378,6 +369,8 @@ Scope NameLookup::unqualified_scope_lookup(const std::shared_ptr<ast::Identifier
  
 NameLookup NameLookup::resolve(const std::shared_ptr<ast::Identifier> & name, const Scope &scp, NameLookupOptions opts)
 {
+  compiler::Profiler::Timer timer{ compiler::Profiler::Phase::NameLookup };
+
   auto result = std::make_shared<NameLookupImpl>();
   result->identifier = name;
   result->scope = scp;
@@ -434,71 +427,121 @@ NameLookup NameLookup::member(const std::string & name, const Class & cla)
   return NameLookup{ result };
 }
 
-static void remove_duplicated_operators(std::vector<Function> & list)
+namespace
 {
-  /// TODO : quicksort and remove duplicate
-  // note that this is not required for OverloadResolution to work
-  // we need to check if that is faster to remove the duplicates or not
-}
 
-static void get_scope_operators(std::vector<Function> & list, OperatorName op, const script::Scope & scp)
+/*
+ * Describes the operators searched by an operator lookup.
+ * When both operands are fundamental types, only the operators whose 
+ * parameters have these exact base types are collected.
+ */
+struct OperatorQuery
 {
-  const auto & candidates = scp.operators();
-  for (const auto & c : candidates)
+  OperatorName op;
+  bool fundamental;
+  Type lhs;
+  Type rhs;
+
+  explicit OperatorQuery(OperatorName o)
+    : op(o), fundamental(false) { }
+
+  OperatorQuery(OperatorName o, const Type & a, const Type & b)
+    : op(o), fundamental(true), lhs(a), rhs(b) { }
+
+  bool matches(const Operator & candidate) const
   {
-    if (c.operatorId() != op)
-      continue;
-    list.push_back(c);
+    if (candidate.operatorId() != op)
+      return false;
+    else if (!fundamental)
+      return true;
+
+    const Prototype & proto = candidate.prototype();
+    return proto.count() == 2 && proto.at(0).baseType() == lhs.baseType() && proto.at(1).baseType() == rhs.baseType();
   }
+};
+
+} // namespace
 
-  if (list.empty() && !scp.parent().isNull())
+static void remove_duplicated_operators(std::vector<Function> & list)
+{
+  // an operator is found once per operand when both operands are 
+  // defined in the same namespace
+  auto end = list.end();
+  for (auto it = list.begin(); it != end; ++it)
+    end = std::remove(std::next(it), end, *it);
+  list.erase(end, list.end());
+}
+
+// returns whether the list of candidates contains an operator named 'q.op'
+static bool get_operators(std::vector<Function> & list, const OperatorQuery & q, const std::vector<Operator> & candidates, SymbolTable *table)
+{
+  if (table == nullptr)
   {
-    get_scope_operators(list, op, scp.parent());
+    bool found = false;
+
+    for (const auto & c : candidates)
+    {
+      if (c.operatorId() != q.op)
+        continue;
+
+      found = true;
+
+      if (q.matches(c))
+        list.push_back(c);
+    }
+
+    return found;
   }
+
+  table->sync(candidates);
+
+  const std::vector<size_t> & indices = q.fundamental ? table->operators(q.op, q.lhs, q.rhs) : table->operators(q.op);
+  for (size_t i : indices)
+    list.push_back(candidates.at(i));
+
+  return !table->operators(q.op).empty();
+}
+
+static void get_scope_operators(std::vector<Function> & list, const OperatorQuery & q, const script::Scope & scp)
+{
+  if (get_operators(list, q, scp.operators(), scp.impl()->symbols()))
+    return;
+
+  if (!scp.parent().isNull())
+    get_scope_operators(list, q, scp.parent());
 }
 
-static void get_operators(std::vector<Function> & list, OperatorName op, const Namespace & ns)
+static void get_operators(std::vector<Function> & list, const OperatorQuery & q, const Namespace & ns)
 {
   if (ns.isNull())
     return;
 
-  const auto & candidates = ns.operators();
-  for (const auto & c : candidates)
-  {
-    if (c.operatorId() != op)
-      continue;
-    list.push_back(c);
-  }
+  get_operators(list, q, ns.operators(), &(ns.impl()->symbols));
 }
 
 
-static void get_operators(std::vector<Function> & list, OperatorName op, const Class & c)
+static void get_operators(std::vector<Function> & list, const OperatorQuery & q, const Class & c)
 {
-  const auto & candidates = c.operators();
-  for (const auto & c : candidates)
-  {
-    if (c.operatorId() != op)
-      continue;
-    list.push_back(c);
-  }
+  get_operators(list, q, c.operators(), &(c.impl()->symbols));
 }
 
-static void resolve_operators(std::vector<Function> &result, OperatorName op, const Class & type)
+static void resolve_operators(std::vector<Function> &result, const OperatorQuery & q, const Class & type)
 {
-  get_operators(result, op, type);
+  get_operators(result, q, type);
 
   /// TODO : optimize for operators that cannot be non-member
   Namespace type_namespace = type.enclosingNamespace();
-  get_operators(result, op, type_namespace);
+  get_operators(result, q, type_namespace);
 
   if (!type.parent().isNull())
-    resolve_operators(result, op, type.parent());
+    resolve_operators(result, q, type.parent());
 }
 
-static void resolve_operators(std::vector<Function> &result, OperatorName op, const Type & type, const Scope & scp)
+static void resolve_operators(std::vector<Function> &result, const OperatorQuery & q, const Type & type, const Scope & scp)
 {
   Engine *engine = scp.engine();
   TypeSystem* ts = engine->typeSystem();
+  const OperatorName op = q.op;
 
   if (type.isClosureType() || type.isFunctionType())
   {
@@ -524,21 +567,22 @@ static void resolve_operators(std::vector<Function> &result, OperatorName op, co
   }
 
   if (type.isObjectType())
-    resolve_operators(result, op, ts->getClass(type));
+    resolve_operators(result, q, ts->getClass(type));
   else 
   {
     Namespace type_namespace = Scope::enclosingNamespace(type, engine);
-    get_operators(result, op, type_namespace);
+    get_operators(result, q, type_namespace);
   }
 }
 
 std::vector<Function> NameLookup::resolve(OperatorName op, const Type & type, const Scope & scp)
 {
   std::vector<Function> result;
+  OperatorQuery q{ op };
 
-  get_scope_operators(result, op, scp);
+  get_scope_operators(result, q, scp);
 
-  resolve_operators(result, op, type, scp);
+  resolve_operators(result, q, type, scp);
 
   remove_duplicated_operators(result);
 
@@ -547,13 +591,33 @@ std::vector<Function> NameLookup::resolve(OperatorName op, const Type & type, co
 
 std::vector<Function> NameLookup::resolve(OperatorName op, const Type & lhs, const Type & rhs, const Scope & scp)
 {
-  /// TODO : this needs some optimization !!
   std::vector<Function> result;
 
-  get_scope_operators(result, op, scp);
+  if (lhs.isFundamentalType() && rhs.isFundamentalType())
+  {
+    // An operator whose parameters exactly match the operands is at least 
+    // as good as any other candidate, so if such operators exist they are 
+    // the only ones that overload resolution needs to consider.
+    OperatorQuery q{ op, lhs, rhs };
+
+    get_scope_operators(result, q, scp);
+
+    resolve_operators(result, q, lhs, scp);
+    resolve_operators(result, q, rhs, scp);
+
+    if (!result.empty())
+    {
+      remove_duplicated_operators(result);
+      return result;
+    }
+  }
+
+  OperatorQuery q{ op };
+
+  get_scope_operators(result, q, scp);
 
-  resolve_operators(result, op, lhs, scp);
-  resolve_operators(result, op, rhs, scp);
+  resolve_operators(result, q, lhs, scp);
+  resolve_operators(result, q, rhs, scp);
 
   remove_duplicated_operators(result);
 
@@ -651,24 +715,26 @@ void NameLookup::qualified_lookup(const std::shared_ptr<ast::Identifier> & name,
   if (s.isNull())
     return;
 
-  ScopeParentGuard guard{ s };
-  s.impl()->parent = nullptr; // temporarily setting parent to nullptr
+  // the lookup is done in a copy of the scope that has no parent, 
+  // the scope itself may be shared and must not be modified
+  Scope scp{ std::shared_ptr<ScopeImpl>(s.impl()->clone()) };
+  scp.impl()->parent = nullptr;
 
   if (name->type() == ast::NodeType::SimpleIdentifier)
   {
-    s.lookup(name->as<ast::SimpleIdentifier>().getName(), d.get());
+    scp.lookup(name->as<ast::SimpleIdentifier>().getName(), d.get());
   }
   else if (name->is<ast::OperatorName>())
   {
     OperatorName op = ast::OperatorName::getOperatorId(name->as<ast::OperatorName>().symbol, ast::OperatorName::All);
-    const auto & ops = s.lookup(op);
+    const auto & ops = scp.lookup(op);
     d->functions.insert(d->functions.end(), ops.begin(), ops.end());
   }
   else if (name->is<ast::TemplateIdentifier>())
   {
     auto tempid = std::static_pointer_cast<ast::TemplateIdentifier>(name);
     auto fake_template_name = ast::SimpleIdentifier::New(tempid->name);
-    qualified_lookup(fake_template_name, s);
+    qualified_lookup(fake_template_name, scp);
     d->functions.clear(); // we only keep templates
 
     if (resultType() == NameLookup::TemplateName)
@@ -13,6 +13,7 @@
 #include "script/script.h"
 
 #include "script/private/class_p.h"
+#include "script/private/engine_p.h"
 #include "script/private/enum_p.h"
 #include "script/private/script_p.h"
 #include "script/private/template_p.h"
@@ -223,6 +224,8 @@ void Namespace::addFunction(const Function& f)
     d->literal_operators.push_back(f.toLiteralOperator());
   else
     d->functions.push_back(f);
+
+  d->engine->implementation()->overload_resolution_cache.invalidate(f);
 }
 
 Engine * Namespace::engine() const
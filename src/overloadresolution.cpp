@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include "script/overloadresolution.h"
+#include "script/private/overloadresolution_p.h"
 
 #include "script/diagnosticmessage.h"
 #include "script/class.h"
@@ -11,6 +12,8 @@
 #include "script/operator.h"
 #include "script/typesystem.h"
 
+#include "script/private/engine_p.h"
+
 #include "script/program/expression.h"
 
 namespace script
@@ -62,4 +65,152 @@ OverloadResolution::OverloadComparison OverloadResolution::compare(const Candida
   return first_diff == -1 ? OverloadResolution::FirstIsBetter : OverloadResolution::SecondIsBetter;
 }
 
-} // namespace script
\ No newline at end of file
+/*!
+ * \fn static bool findCachedResult(const CacheKey& key, Candidate& result)
+ * \brief looks for the result of a previous overload resolution
+ *
+ * Returns true and sets \a result if the same candidates were resolved 
+ * against the same arguments since the engine's functions last changed.
+ */
+bool OverloadResolution::findCachedResult(const CacheKey& key, Candidate& result)
+{
+  Engine* e = key.candidates.front().engine();
+  return e->implementation()->overload_resolution_cache.find(key, result);
+}
+
+/*!
+ * \fn static void cacheResult(CacheKey&& key, const Candidate& result)
+ * \brief stores the result of an overload resolution
+ */
+void OverloadResolution::cacheResult(CacheKey&& key, const Candidate& result)
+{
+  Engine* e = key.candidates.front().engine();
+  e->implementation()->overload_resolution_cache.insert(std::move(key), result);
+}
+
+static bool is_named_function(const Function& f)
+{
+  return !f.isOperator() && !f.isLiteralOperator() && !f.isCast() && !f.isSpecial();
+}
+
+size_t OverloadResolutionCache::Hash::operator()(const OverloadResolution::CacheKey& key) const
+{
+  size_t h = std::hash<int>()(key.object.data());
+
+  for (const Function& f : key.candidates)
+    h = h * 31 + std::hash<const void*>()(f.impl().get());
+
+  for (const Type& t : key.types)
+    h = h * 31 + std::hash<int>()(t.data());
+
+  return h;
+}
+
+bool OverloadResolutionCache::Equal::operator()(const OverloadResolution::CacheKey& a, const OverloadResolution::CacheKey& b) const
+{
+  // types are compared on all their flags, unlike Type::operator==
+  if (a.object.data() != b.object.data() || a.types.size() != b.types.size() || a.candidates != b.candidates)
+    return false;
+
+  for (size_t i(0); i < a.types.size(); ++i)
+  {
+    if (a.types.at(i).data() != b.types.at(i).data())
+      return false;
+  }
+
+  return true;
+}
+
+void OverloadResolutionCache::check_validity()
+{
+  if (m_invalidated.exchange(false))
+  {
+    m_entries.clear();
+    m_names.clear();
+  }
+}
+
+bool OverloadResolutionCache::find(const OverloadResolution::CacheKey& key, OverloadResolution::Candidate& result)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+
+  check_validity();
+
+  auto it = m_entries.find(key);
+
+  if (it == m_entries.end())
+    return false;
+
+  result.function = it->second.function;
+  result.initializations = it->second.initializations;
+  return true;
+}
+
+void OverloadResolutionCache::insert(OverloadResolution::CacheKey&& key, const OverloadResolution::Candidate& result)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+
+  check_validity();
+
+  if (m_entries.size() >= MaxSize)
+  {
+    m_entries.clear();
+    m_names.clear();
+  }
+
+  for (const Function& f : key.candidates)
+  {
+    if (!is_named_function(f))
+      continue;
+
+    m_names.insert(f.name());
+  }
+
+  Entry& entry = m_entries[std::move(key)];
+  entry.function = result.function;
+  entry.initializations = result.initializations;
+}
+
+/*!
+ * \fn void invalidate()
+ * \brief invalidates all the results stored in the cache
+ *
+ * The entries are released on the next access to the cache.
+ */
+void OverloadResolutionCache::invalidate()
+{
+  m_invalidated = true;
+}
+
+/*!
+ * \fn void invalidate(const Function& f)
+ * \brief invalidates the results that may change after \a f is added
+ *
+ * Constructors, conversion functions and operators invalidate all the results. 
+ * Other functions only do if a cached candidate has the same name.
+ */
+void OverloadResolutionCache::invalidate(const Function& f)
+{
+  if (f.isConstructor() || f.isCast() || f.isOperator() || f.isLiteralOperator())
+  {
+    invalidate();
+    return;
+  }
+  else if (!is_named_function(f))
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock{ m_mutex };
+
+  if (m_names.count(f.name()))
+    m_invalidated = true;
+}
+
+size_t OverloadResolutionCache::size() const
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  return m_invalidated ? 0 : m_entries.size();
+}
+
+} // namespace script
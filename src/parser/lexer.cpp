@@ -4,6 +4,7 @@
 
 #include "script/parser/lexer.h"
 
+#include <cassert>
 #include <cstring>
 #include <memory>
 #include <stdexcept>
@@ -157,10 +158,50 @@ char Lexer::currentChar() const noexcept
   return m_source[m_pos];
 }
 
+namespace
+{
+
+enum CharFlag {
+  IdentifierChar = 1, // letters, digits and underscore
+  DiscardableChar = 2, // spaces, tabulations and line breaks
+};
+
+// classification of the 256 char values, used by the scanning loops
+// that consume whole runs of characters
+struct CharFlags
+{
+  unsigned char flags[256];
+
+  CharFlags()
+  {
+    for (int i(0); i < 256; ++i)
+    {
+      const Lexer::CharacterType ct = Lexer::ctype(static_cast<char>(i));
+      flags[i] = 0;
+
+      if (ct == Lexer::Letter || ct == Lexer::Digit || ct == Lexer::Underscore)
+        flags[i] |= IdentifierChar;
+      else if (ct == Lexer::Space || ct == Lexer::LineBreak || ct == Lexer::CarriageReturn || ct == Lexer::Tabulation)
+        flags[i] |= DiscardableChar;
+    }
+  }
+
+  inline bool test(char c, CharFlag f) const { return flags[static_cast<unsigned char>(c)] & f; }
+};
+
+const CharFlags char_flags = {};
+
+} // namespace
+
 void Lexer::consumeDiscardable()
 {
-  while (!atEnd() && isDiscardable(peekChar())) 
-    readChar();
+  const char *it = m_source + m_pos;
+  const char *end = m_source + m_size;
+
+  while (it != end && char_flags.test(*it, DiscardableChar))
+    ++it;
+
+  m_pos = it - m_source;
 }
 
 Token Lexer::create(size_t pos, size_t length, Token::Id type, int flags)
@@ -306,14 +347,16 @@ Lexer::CharacterType Lexer::ctype(char c)
     Invalid, // DEL    (delete)
   };
 
-  if(c <= 127)
-    return map[c];
+  const unsigned char uc = static_cast<unsigned char>(c);
+
+  if(uc <= 127)
+    return map[uc];
   return Other;
 }
 
 bool Lexer::isDiscardable(char c)
 {
-  return ctype(c) == Space || ctype(c) == LineBreak || ctype(c) == CarriageReturn || ctype(c) == Tabulation;
+  return char_flags.test(c, DiscardableChar);
 }
 
 
@@ -512,8 +555,13 @@ bool Lexer::tryReadLiteralSuffix()
 
 Token Lexer::readIdentifier(size_t start)
 {
-  while (!this->atEnd() && (Lexer::isLetter(peekChar()) || Lexer::isDigit(peekChar()) || peekChar() == '_'))
-    readChar();
+  const char *it = m_source + m_pos;
+  const char *end = m_source + m_size;
+
+  while (it != end && char_flags.test(*it, IdentifierChar))
+    ++it;
+
+  m_pos = it - m_source;
 
   Token::Id id = identifierType(start, pos());
 
@@ -529,16 +577,10 @@ struct Keyword {
   Token::Id toktype;
 };
 
-const Keyword l2k[] = {
+constexpr Keyword keywords[] = {
   { "if", Token::If },
-};
-
-const Keyword l3k[] = {
   { "for", Token::For },
   { "int", Token::Int },
-};
-
-const Keyword l4k[] = {
   { "auto", Token::Auto },
   { "bool", Token::Bool },
   { "char", Token::Char },
@@ -547,9 +589,6 @@ const Keyword l4k[] = {
   { "this", Token::This },
   { "true", Token::True },
   { "void", Token::Void },
-};
-
-const Keyword l5k[] = {
   { "break", Token::Break },
   { "class", Token::Class },
   { "const", Token::Const },
@@ -557,9 +596,6 @@ const Keyword l5k[] = {
   { "float", Token::Float },
   { "using", Token::Using },
   { "while", Token::While },
-};
-
-const Keyword l6k[] = {
   { "delete", Token::Delete },
   { "double", Token::Double },
   { "export", Token::Export },
@@ -570,65 +606,86 @@ const Keyword l6k[] = {
   { "static", Token::Static },
   { "struct", Token::Struct },
   { "typeid", Token::Typeid },
-};
-
-const Keyword l7k[] = {
   { "default", Token::Default },
   { "mutable", Token::Mutable },
   { "private", Token::Private },
   { "typedef", Token::Typedef },
   { "virtual", Token::Virtual },
-};
-
-const Keyword l8k[] = {
   { "continue", Token::Continue },
   { "explicit", Token::Explicit },
   { "operator", Token::Operator },
   { "template", Token::Template },
   { "typename", Token::Typename },
-};
-
-const Keyword l9k[] = {
   { "namespace", Token::Namespace },
   { "protected", Token::Protected },
 };
 
-static Token::Id findKeyword(const Keyword * keywords, size_t arraySize, const char *str, size_t length)
+/*
+ * Perfect hash of the keywords: the function below maps each keyword 
+ * to a distinct slot of a 128-entry table, so that recognizing a keyword 
+ * requires a single comparison.
+ * The coefficients were found by exhaustive search over the keyword list;
+ * they must be searched again if a keyword is added (the table is built 
+ * at compile time and a static_assert checks that there is no collision).
+ */
+static constexpr size_t keyword_hash(const char *str, size_t length)
 {
-  for (int i(0); i < arraySize; ++i) {
-    if (std::memcmp(keywords[i].name, str, length) == 0)
-      return keywords[i].toktype;
-  }
-  return Token::UserDefinedName;
+  return (4 * static_cast<unsigned char>(str[0]) + 3 * static_cast<unsigned char>(str[length - 1])
+    + static_cast<unsigned char>(str[1]) + length) & 127;
 }
 
+struct KeywordTable
+{
+  struct Entry {
+    const char *name = nullptr;
+    size_t length = 0;
+    Token::Id toktype = Token::UserDefinedName;
+  };
+
+  Entry entries[128];
+  size_t collisions = 0;
+
+  static constexpr size_t length(const char *str)
+  {
+    size_t n = 0;
+    while (str[n] != '\0')
+      ++n;
+    return n;
+  }
+
+  constexpr KeywordTable()
+  {
+    for (const Keyword & k : keywords)
+    {
+      const size_t l = length(k.name);
+      Entry & e = entries[keyword_hash(k.name, l)];
+
+      if (e.name != nullptr)
+        ++collisions;
+
+      e.name = k.name;
+      e.length = l;
+      e.toktype = k.toktype;
+    }
+  }
+};
+
+static constexpr KeywordTable keyword_table = {};
+
+static_assert(keyword_table.collisions == 0, "keyword_hash() must map each keyword to a distinct entry");
+
 Token::Id Lexer::identifierType(size_t begin, size_t end) const
 {
   const char *str = m_source + begin;
   const size_t l = end - begin;
 
-  switch (l) {
-  case 1:
+  if (l < 2 || l > 9)
     return Token::UserDefinedName;
-  case 2:
-    return findKeyword(l2k, sizeof(l2k) / sizeof(Keyword), str, l);
-  case 3:
-    return findKeyword(l3k, sizeof(l3k) / sizeof(Keyword), str, l);
-  case 4:
-    return findKeyword(l4k, sizeof(l4k) / sizeof(Keyword), str, l);
-  case 5:
-    return findKeyword(l5k, sizeof(l5k) / sizeof(Keyword), str, l);
-  case 6:
-    return findKeyword(l6k, sizeof(l6k) / sizeof(Keyword), str, l);
-  case 7:
-    return findKeyword(l7k, sizeof(l7k) / sizeof(Keyword), str, l);
-  case 8:
-    return findKeyword(l8k, sizeof(l8k) / sizeof(Keyword), str, l);
-  case 9:
-    return findKeyword(l9k, sizeof(l9k) / sizeof(Keyword), str, l);
-  default:
-    break;
-  }
+
+  const KeywordTable::Entry & e = keyword_table.entries[keyword_hash(str, l)];
+
+  if (e.length == l && std::memcmp(e.name, str, l) == 0)
+    return e.toktype;
 
   return Token::UserDefinedName;
 }
@@ -827,8 +884,8 @@ Token Lexer::readSingleLineComment(size_t start)
 {
   readChar(); // reads the second '/'
 
-  while (!atEnd() && peekChar() != '\n')
-    readChar();
+  const void *eol = std::memchr(m_source + m_pos, '\n', m_size - m_pos);
+  m_pos = eol != nullptr ? static_cast<const char*>(eol) - m_source : m_size;
 
   return create(start, Token::SingleLineComment, 0);
 }
@@ -838,8 +895,8 @@ Token Lexer::readMultiLineComment(size_t start)
   readChar(); // reads the '*' after opening '/'
 
   do {
-    while (!atEnd() && peekChar() != '*')
-      readChar();
+    const void *star = std::memchr(m_source + m_pos, '*', m_size - m_pos);
+    m_pos = star != nullptr ? static_cast<const char*>(star) - m_source : m_size;
 
     if (atEnd())
       throw std::runtime_error{ "Lexer::readMultiLineComment() : unexpected end of input before end of comment" };
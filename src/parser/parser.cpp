@@ -6,9 +6,13 @@
 #include "script/parser/specific-parsers.h"
 
 #include "script/parser/lexer.h"
+#include "script/parser/token-stream.h"
 
 #include "script/parser/delimiters-counter.h"
 
+#include <exception>
+#include <thread>
+
 namespace script
 {
 
@@ -47,6 +51,44 @@ ParserContext::~ParserContext()
 
 }
 
+/*!
+ * \fn bool refill(TokenStream& stream)
+ * \param token source
+ * \brief replaces the tokens of the context by those of the next top-level statement
+ *
+ * Returns false if the stream has no more tokens.
+ */
+bool ParserContext::refill(TokenStream& stream)
+{
+  m_size = stream.source_length();
+  m_memos.clear();
+  return stream.readStatement(m_tokens);
+}
+
+/*!
+ * \fn const Memo* findMemo(size_t begin, size_t end) const
+ * \param index of the first token
+ * \param index past the last token
+ * \brief returns the memoized result of a parse of a range of tokens, or nullptr
+ */
+const ParserContext::Memo* ParserContext::findMemo(size_t begin, size_t end) const
+{
+  auto it = m_memos.find(std::make_pair(begin, end));
+  return it != m_memos.end() ? &(it->second) : nullptr;
+}
+
+/*!
+ * \fn void memoize(size_t begin, size_t end, Memo memo)
+ * \param index of the first token
+ * \param index past the last token
+ * \param result of the parse
+ * \brief stores the result of a parse of a range of tokens
+ */
+void ParserContext::memoize(size_t begin, size_t end, Memo memo)
+{
+  m_memos[std::make_pair(begin, end)] = std::move(memo);
+}
+
 ParserBase::ParserBase(std::shared_ptr<ParserContext> shared_context, const TokenReader& reader)
   : TokenReader(reader),
     m_context(shared_context)
@@ -1092,6 +1134,42 @@ TemplateArgParser::TemplateArgParser(std::shared_ptr<ParserContext> shared_conte
 }
 
 std::shared_ptr<ast::Node> TemplateArgParser::parse()
+{
+  // a template argument is parsed again each time an enclosing construct 
+  // is reparsed (e.g. a template argument that turns out to be an expression 
+  // rather than a type); without memoization, nested template arguments 
+  // are parsed a number of times exponential in their depth.
+  const size_t begin = std::distance(context()->tokens().begin(), fragment().begin());
+  const size_t end = begin + fragment().size();
+
+  if (const ParserContext::Memo* memo = context()->findMemo(begin, end))
+  {
+    if (memo->error)
+      std::rethrow_exception(memo->error);
+
+    seek(context()->tokens().begin() + memo->end);
+    return memo->node;
+  }
+
+  ParserContext::Memo memo;
+
+  try
+  {
+    memo.node = parseArgument();
+    memo.end = std::distance(context()->tokens().begin(), iterator());
+  }
+  catch (const SyntaxError&)
+  {
+    memo.error = std::current_exception();
+    context()->memoize(begin, end, std::move(memo));
+    throw;
+  }
+
+  context()->memoize(begin, end, memo);
+  return memo.node;
+}
+
+std::shared_ptr<ast::Node> TemplateArgParser::parseArgument()
 {
   auto p = iterator();
 
@@ -1280,7 +1358,7 @@ bool TypeParser::lookAheadFunctionSignature()
 ast::QualifiedType TypeParser::tryReadFunctionSignature(const ast::QualifiedType & rt)
 {
   ast::QualifiedType ret;
-  ret.functionType = std::make_shared<ast::FunctionType>();
+  ret.functionType = ast::make_node<ast::FunctionType>();
   ret.functionType->returnType = rt;
   
   TokenReader params_reader = subfragment<Fragment::DelimiterPair>();
@@ -2758,21 +2836,179 @@ Parser::Parser(const char* str)
 
 }
 
+Parser::Parser(const char* str, size_t size)
+  : ProgramParser(std::make_shared<ParserContext>(str, size))
+{
+
+}
+
 const std::vector<Token>& Parser::tokens() const
 {
   return context()->tokens();
 }
 
+static std::shared_ptr<ast::AST> parse_sequential(const SourceFile& source, SourceFile src)
+{
+  // the arena is created first so that the nodes memoized by the context 
+  // are destroyed before it if parsing fails
+  auto arena = std::make_shared<ast::Arena>();
+  ast::ArenaScope arena_scope{ arena };
+
+  TokenStream stream{ src.data(), src.size() };
+  auto context = std::make_shared<ParserContext>(src.data(), std::vector<Token>());
+
+  std::shared_ptr<ast::AST> ret = std::make_shared<ast::AST>(source);
+  ret->arena = arena;
+  ret->root = ast::ScriptRootNode::New(ret);
+
+  // top-level statements are tokenized and parsed one at a time so that 
+  // the tokens of the whole file never need to be held in memory
+  while (context->refill(stream))
+  {
+    ProgramParser p{ context };
+
+    while (!p.atEnd())
+    {
+      ret->add(p.parseStatement());
+    }
+  }
+
+  return ret;
+}
+
+/*!
+ * \fn std::shared_ptr<ast::AST> parse(const SourceFile& source)
+ * \param source file
+ * \brief parses a source file on the calling thread
+ */
 std::shared_ptr<ast::AST> parse(const SourceFile& source)
 {
-  Parser p{ loaded_source_file(source).content() };
+  return parse_sequential(source, loaded_source_file(source));
+}
+
+namespace
+{
+
+struct ParsedGroup
+{
+  Fragment::iterator begin;
+  Fragment::iterator end;
+  std::shared_ptr<ast::Arena> arena;
+  std::vector<std::shared_ptr<ast::Statement>> statements;
+  std::exception_ptr error;
+};
+
+} // namespace
+
+static void parse_group(const std::shared_ptr<ParserContext>& shared_context, ParsedGroup& group)
+{
+  group.arena = std::make_shared<ast::Arena>();
+  ast::ArenaScope arena_scope{ group.arena };
+
+  try
+  {
+    // each group gets its own context as memoized results are stored in the context
+    auto context = std::make_shared<ParserContext>(shared_context->source(), std::vector<Token>(group.begin, group.end));
+    ProgramParser p{ context };
+
+    while (!p.atEnd())
+    {
+      group.statements.push_back(p.parseStatement());
+    }
+  }
+  catch (...)
+  {
+    group.error = std::current_exception();
+  }
+}
+
+/*!
+ * \fn std::shared_ptr<ast::AST> parse(const SourceFile& source, size_t threads)
+ * \param source file
+ * \param number of threads
+ * \brief parses a source file using several threads
+ *
+ * The source is split at top-level statement boundaries in groups of roughly 
+ * equal number of tokens; each group is parsed on its own thread and in its 
+ * own arena. The statements are then added to the AST in source order.
+ * If several groups contain a syntax error, the first one in the source is thrown.
+ */
+std::shared_ptr<ast::AST> parse(const SourceFile& source, size_t threads)
+{
+  SourceFile src = loaded_source_file(source);
+
+  if (threads <= 1)
+    return parse_sequential(source, src);
+
+  std::vector<Token> tokens;
+  std::vector<size_t> boundaries;
+
+  {
+    TokenStream stream{ src.data(), src.size() };
+    std::vector<Token> buffer;
+
+    while (stream.readStatement(buffer))
+    {
+      tokens.insert(tokens.end(), buffer.begin(), buffer.end());
+      boundaries.push_back(tokens.size());
+    }
+  }
+
+  auto context = std::make_shared<ParserContext>(src.data(), std::move(tokens));
+
+  std::vector<ParsedGroup> groups;
+
+  {
+    const size_t group_size = (context->tokens().size() + threads - 1) / threads;
+    size_t begin = 0;
+
+    for (size_t b : boundaries)
+    {
+      if (b - begin < group_size && b != context->tokens().size())
+        continue;
+
+      ParsedGroup g;
+      g.begin = context->tokens().begin() + begin;
+      g.end = context->tokens().begin() + b;
+      groups.push_back(std::move(g));
+      begin = b;
+    }
+  }
+
+  std::vector<std::thread> workers;
+
+  for (size_t i(1); i < groups.size(); ++i)
+  {
+    try
+    {
+      workers.emplace_back(parse_group, std::cref(context), std::ref(groups[i]));
+    }
+    catch (const std::system_error&)
+    {
+      parse_group(context, groups[i]);
+    }
+  }
+
+  if (!groups.empty())
+    parse_group(context, groups.front());
+
+  for (std::thread& t : workers)
+    t.join();
 
   std::shared_ptr<ast::AST> ret = std::make_shared<ast::AST>(source);
+  ret->arena = std::make_shared<ast::Arena>();
+  ast::ArenaScope arena_scope{ ret->arena };
   ret->root = ast::ScriptRootNode::New(ret);
 
-  while (!p.atEnd())
+  for (ParsedGroup& g : groups)
   {
-    ret->add(p.parseStatement());
+    if (g.error)
+      std::rethrow_exception(g.error);
+
+    ret->arena->adopt(g.arena);
+
+    for (const auto& stmt : g.statements)
+      ret->add(stmt);
   }
 
   return ret;
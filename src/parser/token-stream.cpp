@@ -0,0 +1,110 @@
+// Copyright (C) 2018 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "script/parser/token-stream.h"
+
+#include "script/parser/delimiters-counter.h"
+
+namespace script
+{
+
+namespace parser
+{
+
+TokenStream::TokenStream(const char* src, size_t len)
+  : m_source(src),
+    m_size(len),
+    m_lexer(src, len)
+{
+
+}
+
+/*!
+ * \fn bool atEnd()
+ * \brief returns whether all the tokens have been read
+ */
+bool TokenStream::atEnd()
+{
+  return peek() == Token::Invalid;
+}
+
+const Token& TokenStream::peek()
+{
+  while (m_lookahead == Token::Invalid && !m_lexer.atEnd())
+  {
+    Token t = m_lexer.read();
+
+    if (!Lexer::isDiscardable(t))
+      m_lookahead = t;
+  }
+
+  return m_lookahead;
+}
+
+Token TokenStream::read()
+{
+  Token ret = peek();
+  m_lookahead = Token();
+  return ret;
+}
+
+/*!
+ * \fn bool readStatement(std::vector<Token>& tokens)
+ * \param output buffer
+ * \brief reads the tokens of the next top-level statement
+ *
+ * The buffer is cleared before reading; its capacity is retained so that a single 
+ * buffer can be reused for the whole input.
+ * A statement ends with a semicolon or with a closing brace that is not followed 
+ * by a token continuing the statement (e.g. an operator or an 'else').
+ * Unbalanced delimiters end the statement early so that the parser can report 
+ * the error.
+ *
+ * Returns false if the end of the input was reached before any token was read.
+ */
+bool TokenStream::readStatement(std::vector<Token>& tokens)
+{
+  tokens.clear();
+
+  DelimitersCounter counter;
+
+  while (!atEnd())
+  {
+    Token tok = read();
+    tokens.push_back(tok);
+    counter.feed(tok);
+
+    if (counter.invalid())
+      break;
+    else if (!counter.balanced())
+      continue;
+
+    if (tok == Token::Semicolon)
+      break;
+
+    if (tok != Token::RightBrace)
+      continue;
+
+    const Token& next = peek();
+
+    if (next == Token::Semicolon)
+    {
+      tokens.push_back(read());
+      break;
+    }
+    else if (next == Token::Else || next == Token::Comma || next == Token::LeftPar
+      || next == Token::LeftBracket || next == Token::Dot || next.isOperator())
+    {
+      continue;
+    }
+
+    break;
+  }
+
+  return !tokens.empty();
+}
+
+} // namespace parser
+
+} // namespace script
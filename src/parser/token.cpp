@@ -12,6 +12,8 @@ namespace script
 namespace parser
 {
 
+static_assert(sizeof(Token) <= sizeof(const char*) + 8, "Token should be kept compact");
+
 static std::vector<std::string> build_token_type_strings()
 {
   std::vector<std::string> result;
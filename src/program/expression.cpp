@@ -46,6 +46,11 @@ Value Copy::accept(ExpressionVisitor & visitor)
   return visitor.visit(*this);
 }
 
+Value EnumAssignment::accept(ExpressionVisitor & visitor)
+{
+  return visitor.visit(*this);
+}
+
 Value FetchGlobal::accept(ExpressionVisitor & visitor)
 {
   return visitor.visit(*this);
@@ -101,6 +106,11 @@ Value StackValue::accept(ExpressionVisitor & visitor)
   return visitor.visit(*this);
 }
 
+Value StringConcatenation::accept(ExpressionVisitor & visitor)
+{
+  return visitor.visit(*this);
+}
+
 Value VariableAccess::accept(ExpressionVisitor & visitor)
 {
   return visitor.visit(*this);
@@ -338,6 +348,26 @@ std::shared_ptr<Copy> Copy::New(const Type & t, const std::shared_ptr<Expression
 
 
 
+EnumAssignment::EnumAssignment(const Type & t, const std::shared_ptr<Expression> & l, const std::shared_ptr<Expression> & r)
+  : value_type(t)
+  , lhs(l)
+  , rhs(r)
+{
+
+}
+
+Type EnumAssignment::type() const
+{
+  return value_type;
+}
+
+std::shared_ptr<EnumAssignment> EnumAssignment::New(const Type & t, const std::shared_ptr<Expression> & l, const std::shared_ptr<Expression> & r)
+{
+  return std::make_shared<EnumAssignment>(t, l, r);
+}
+
+
+
 FundamentalConversion::FundamentalConversion(const Type & t, const std::shared_ptr<Expression> & arg)
   : dest_type(t)
   , argument(arg)
@@ -515,6 +545,24 @@ std::shared_ptr<FunctionVariableCall> FunctionVariableCall::New(const std::share
   return std::make_shared<FunctionVariableCall>(fv, rt, std::move(args));
 }
 
+
+
+StringConcatenation::StringConcatenation(std::vector<std::shared_ptr<Expression>> && ops)
+  : operands(std::move(ops))
+{
+
+}
+
+Type StringConcatenation::type() const
+{
+  return Type::String;
+}
+
+std::shared_ptr<StringConcatenation> StringConcatenation::New(std::vector<std::shared_ptr<Expression>> && ops)
+{
+  return std::make_shared<StringConcatenation>(std::move(ops));
+}
+
 } // namespace program
 
 } // namespace script
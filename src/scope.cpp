@@ -21,6 +21,8 @@
 #include "script/namelookup.h"
 #include "script/private/namelookup_p.h"
 
+#include "script/compiler/readonlyengine.h"
+
 #include <algorithm>
 
 namespace script
@@ -33,11 +35,9 @@ ScopeImpl::ScopeImpl(std::shared_ptr<ScopeImpl> p)
 }
 
 ScopeImpl::ScopeImpl(const ScopeImpl & other)
+  : parent(other.parent)
 {
-  if (other.parent != nullptr)
-  {
-    this->parent = std::shared_ptr<ScopeImpl>(other.parent->clone());
-  }
+
 }
 
 bool ScopeImpl::handle_injections() const
@@ -53,20 +53,10 @@ void ScopeImpl::inject(const NameLookupImpl *nl)
     if (this->parent == nullptr)
       throw std::runtime_error{ "Scope does not supprot injection" };
 
-    if (this->parent.use_count() == 1)
-    {
-      this->parent->inject(nl);
-    }
-    else
-    {
-      if (this->parent->handle_injections())
-      {
-        this->parent = std::shared_ptr<ScopeImpl>(this->parent->clone());
-      }
-
-      this->parent->inject(nl);
-    }
+    if (this->parent.use_count() != 1)
+      this->parent = std::shared_ptr<ScopeImpl>(this->parent->clone());
 
+    this->parent->inject(nl);
     return;
   }
 
@@ -74,11 +64,11 @@ void ScopeImpl::inject(const NameLookupImpl *nl)
   {
     if (nl->typeResult.isEnumType())
     {
-      extensible->injected_enums.push_back(engine()->typeSystem()->getEnum(nl->typeResult));
+      extensible->injections_for_write().enums.push_back(engine()->typeSystem()->getEnum(nl->typeResult));
     }
     else if (nl->typeResult.isObjectType())
     {
-      extensible->injected_classes.push_back(engine()->typeSystem()->getClass(nl->typeResult));
+      extensible->injections_for_write().classes.push_back(engine()->typeSystem()->getClass(nl->typeResult));
     }
     else
     {
@@ -87,7 +77,8 @@ void ScopeImpl::inject(const NameLookupImpl *nl)
   }
   else if (!nl->functions.empty())
   {
-    extensible->injected_functions.insert(extensible->injected_functions.end(), nl->functions.begin(), nl->functions.end());
+    std::vector<Function> & functions = extensible->injections_for_write().functions;
+    functions.insert(functions.end(), nl->functions.begin(), nl->functions.end());
   }
   
   /// TODO : handle values and templates
@@ -101,24 +92,14 @@ void ScopeImpl::inject(const std::string & name, const Type & t)
     if (this->parent == nullptr)
       throw std::runtime_error{ "Scope does not supprot injection" };
 
-    if (this->parent.use_count() == 1)
-    {
-      this->parent->inject(name, t);
-    }
-    else
-    {
-      if (this->parent->handle_injections())
-      {
-        this->parent = std::shared_ptr<ScopeImpl>(this->parent->clone());
-      }
-
-      this->parent->inject(name, t);
-    }
+    if (this->parent.use_count() != 1)
+      this->parent = std::shared_ptr<ScopeImpl>(this->parent->clone());
 
+    this->parent->inject(name, t);
     return;
   }
 
-  extensible->type_aliases[name] = t;
+  extensible->injections_for_write().type_aliases[name] = t;
 }
 
 const std::vector<Class> ScopeImpl::static_dummy_classes = std::vector<Class>{};
@@ -176,8 +157,102 @@ const std::vector<Typedef> & ScopeImpl::typedefs() const
   return static_dummy_typedefs;
 }
 
+static bool lookup_enumerator(const std::string & name, const std::vector<Enum> & enums, NameLookupImpl *nl)
+{
+  for (const auto & e : enums)
+  {
+    if (e.isEnumClass())
+      continue;
+
+    auto it = e.values().find(name);
+    if (it != e.values().end())
+    {
+      nl->enumeratorResult = Enumerator{ e, it->second };
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool lookup_symbols(const std::string & name, SymbolTable & table, const std::vector<Enum> & enums, const std::vector<Class> & classes,
+  const std::vector<Typedef> & typedefs, const std::map<std::string, Value> & values, const std::vector<Function> & functions,
+  const std::vector<Template> & templates, NameLookupImpl *nl)
+{
+  table.sync(enums, classes, typedefs, functions, templates);
+  const SymbolTable::Entry *entry = table.find(name);
+
+  if (entry != nullptr && !entry->enums.empty())
+  {
+    nl->typeResult = enums.at(entry->enums.front()).id();
+    return true;
+  }
+
+  if (lookup_enumerator(name, enums, nl))
+    return true;
+
+  if (entry != nullptr && !entry->classes.empty())
+  {
+    nl->typeResult = classes.at(entry->classes.front()).id();
+    return true;
+  }
+
+  if (entry != nullptr && !entry->typedefs.empty())
+  {
+    nl->typeResult = typedefs.at(entry->typedefs.front()).type();
+    return true;
+  }
+
+  auto it = values.find(name);
+  if (it != values.end())
+  {
+    // copying a value modifies its reference count
+    compiler::ReadOnlyEngine::check();
+    nl->valueResult = it->second;
+    return true;
+  }
+
+  if (entry == nullptr)
+    return false;
+
+  for (size_t i : entry->functions)
+    nl->functions.push_back(functions.at(i));
+
+  for (size_t i : entry->templates)
+  {
+    const Template & t = templates.at(i);
+
+    if (t.isClassTemplate())
+    {
+      nl->classTemplateResult = t.asClassTemplate();
+      return true;
+    }
+    else
+    {
+      nl->functionTemplateResult.push_back(t.asFunctionTemplate());
+    }
+  }
+
+  return !entry->functions.empty() || !entry->templates.empty();
+}
+
+/*!
+ * \fn SymbolTable* symbols() const
+ * \brief returns the name index of the symbols of this scope
+ *
+ * Scopes that do not provide an index are searched linearly.
+ */
+SymbolTable* ScopeImpl::symbols() const
+{
+  return nullptr;
+}
+
 bool ScopeImpl::lookup(const std::string & name, NameLookupImpl *nl) const
 {
+  SymbolTable *table = symbols();
+
+  if (table != nullptr)
+    return lookup_symbols(name, *table, enums(), classes(), typedefs(), values(), functions(), templates(), nl);
 
   for (const auto & e : enums())
   {
@@ -220,6 +295,7 @@ bool ScopeImpl::lookup(const std::string & name, NameLookupImpl *nl) const
   auto it = vars.find(name);
   if (it != vars.end())
   {
+    compiler::ReadOnlyEngine::check();
     nl->valueResult = it->second;
     return true;
   }
@@ -271,72 +347,86 @@ ExtensibleScope::ExtensibleScope(std::shared_ptr<ScopeImpl> p)
 
 ExtensibleScope::ExtensibleScope(const ExtensibleScope & other)
   : ScopeImpl(other)
-  , type_aliases(other.type_aliases)
-  , injected_classes(other.injected_classes)
-  , injected_enums(other.injected_enums)
-  , injected_functions(other.injected_functions)
-  , injected_values(other.injected_values)
-  , injected_typedefs(other.injected_typedefs)
+  , injections(other.injections)
+{
+
+}
+
+/*!
+ * \fn Injections & injections_for_write()
+ * \brief returns the injections of this scope, copying them if they are shared
+ */
+ExtensibleScope::Injections & ExtensibleScope::injections_for_write()
 {
+  if (injections == nullptr)
+  {
+    injections = std::make_shared<Injections>();
+  }
+  else if (injections.use_count() != 1)
+  {
+    // copying a value modifies its reference count
+    if (!injections->values.empty())
+      compiler::ReadOnlyEngine::check();
 
+    injections = std::make_shared<Injections>(*injections);
+  }
+
+  return *injections;
 }
 
 bool ExtensibleScope::lookup(const std::string & name, NameLookupImpl *nl) const
 {
+  if (injections == nullptr)
+    return ScopeImpl::lookup(name, nl);
+
   {
-    auto it = type_aliases.find(name);
-    if (it != type_aliases.end())
+    auto it = injections->type_aliases.find(name);
+    if (it != injections->type_aliases.end())
     {
       nl->typeResult = it->second;
       return true;
     }
   }
 
-  for (const auto & c : injected_classes)
+  injections->symbols.sync(injections->enums, injections->classes, injections->typedefs, injections->functions, static_dummy_templates);
+  const SymbolTable::Entry *injected = injections->symbols.find(name);
+
+  if (injected != nullptr && !injected->classes.empty())
   {
-    if (c.name() == name)
-    {
-      nl->typeResult = c.id();
-      return true;
-    }
+    nl->typeResult = injections->classes.at(injected->classes.front()).id();
+    return true;
   }
 
-  for (const auto & e : injected_enums)
+  if (injected != nullptr && !injected->enums.empty())
   {
-    if (e.name() == name)
-    {
-      nl->typeResult = e.id();
-      return true;
-    }
+    nl->typeResult = injections->enums.at(injected->enums.front()).id();
+    return true;
   }
 
   {
-    auto it = injected_values.find(name);
-    if (it != injected_values.end())
+    auto it = injections->values.find(name);
+    if (it != injections->values.end())
     {
+      compiler::ReadOnlyEngine::check();
       nl->valueResult = it->second;
       return true;
     }
   }
 
-  for (const auto & td : injected_typedefs)
+  if (injected != nullptr && !injected->typedefs.empty())
   {
-    if (td.name() == name)
-    {
-      nl->typeResult = td.type();
-      return true;
-    }
+    nl->typeResult = injections->typedefs.at(injected->typedefs.front()).type();
+    return true;
   }
 
-  const size_t size_before = nl->functions.size();
-  for (const auto & f : injected_functions)
+  if (injected != nullptr)
   {
-    if (f.name() == name)
-      nl->functions.push_back(f);
+    for (size_t i : injected->functions)
+      nl->functions.push_back(injections->functions.at(i));
   }
 
   const bool found = ScopeImpl::lookup(name, nl);
-  return found || (nl->functions.size() != size_before);
+  return found || (injected != nullptr && !injected->functions.empty());
 }
 
 
@@ -350,8 +440,14 @@ NamespaceScope::NamespaceScope(const Namespace & ns, std::shared_ptr<ScopeImpl>
 NamespaceScope::NamespaceScope(const NamespaceScope & other)
   : ExtensibleScope(other)
   , mNamespace(other.mNamespace)
-  , mImportedNamespaces(other.mImportedNamespaces)
-  , mNamespaceAliases(other.mNamespaceAliases)
+  , mImports(other.mImports)
+{
+
+}
+
+NamespaceScope::Imports::Imports(const Imports & other)
+  : namespaces(other.namespaces)
+  , aliases(other.aliases)
 {
 
 }
@@ -397,7 +493,7 @@ std::shared_ptr<NamespaceScope> NamespaceScope::child_scope(const std::string &
     }
   }
 
-  for (const auto & ins : mImportedNamespaces)
+  for (const auto & ins : imported_namespaces())
   {
     for (const auto & ns : ins.namespaces())
     {
@@ -413,7 +509,8 @@ std::shared_ptr<NamespaceScope> NamespaceScope::child_scope(const std::string &
     return nullptr;
 
   auto ret = std::make_shared<script::NamespaceScope>(base);
-  ret->mImportedNamespaces = std::move(imported);
+  if (!imported.empty())
+    ret->imports_for_write().namespaces = std::move(imported);
   return ret;
 }
 
@@ -431,7 +528,7 @@ bool NamespaceScope::has_child(const std::string & name) const
     }
   }
 
-  for (const auto & ins : mImportedNamespaces)
+  for (const auto & ins : imported_namespaces())
   {
     for (const auto & ns : ins.namespaces())
     {
@@ -445,62 +542,70 @@ bool NamespaceScope::has_child(const std::string & name) const
 
 const std::vector<Class> & NamespaceScope::classes() const
 {
-  if (mImportedNamespaces.empty())
+  if (imported_namespaces().empty())
     return mNamespace.classes();
 
-  if (mClasses.empty())
+  std::lock_guard<std::mutex> lock{ mImports->mutex };
+
+  if (mImports->classes.empty())
   {
-    mClasses = mNamespace.isNull() ? std::vector<Class>{} : mNamespace.classes();
-    for (const auto & ns : mImportedNamespaces)
-      mClasses.insert(mClasses.end(), ns.classes().begin(), ns.classes().end());
+    mImports->classes = mNamespace.isNull() ? std::vector<Class>{} : mNamespace.classes();
+    for (const auto & ns : mImports->namespaces)
+      mImports->classes.insert(mImports->classes.end(), ns.classes().begin(), ns.classes().end());
   }
 
-  return mClasses;
+  return mImports->classes;
 }
 
 const std::vector<Enum> & NamespaceScope::enums() const
 {
-  if (mImportedNamespaces.empty())
+  if (imported_namespaces().empty())
     return mNamespace.enums();
 
-  if (mEnums.empty())
+  std::lock_guard<std::mutex> lock{ mImports->mutex };
+
+  if (mImports->enums.empty())
   {
-    mEnums = mNamespace.isNull() ? std::vector<Enum>{} : mNamespace.enums();
-    for (const auto & ns : mImportedNamespaces)
-      mEnums.insert(mEnums.end(), ns.enums().begin(), ns.enums().end());
+    mImports->enums = mNamespace.isNull() ? std::vector<Enum>{} : mNamespace.enums();
+    for (const auto & ns : mImports->namespaces)
+      mImports->enums.insert(mImports->enums.end(), ns.enums().begin(), ns.enums().end());
   }
 
-  return mEnums;
+  return mImports->enums;
 }
 
 const std::vector<Function> & NamespaceScope::functions() const
 {
-  if (mImportedNamespaces.empty())
+  if (imported_namespaces().empty())
     return mNamespace.functions();
 
-  if (mFunctions.empty())
+  std::lock_guard<std::mutex> lock{ mImports->mutex };
+
+  if (mImports->functions.empty())
   {
-    mFunctions = mNamespace.isNull() ? std::vector<Function>{} : mNamespace.functions();
-    for (const auto & ns : mImportedNamespaces)
-      mFunctions.insert(mFunctions.end(), ns.functions().begin(), ns.functions().end());
+    mImports->functions = mNamespace.isNull() ? std::vector<Function>{} : mNamespace.functions();
+    for (const auto & ns : mImports->namespaces)
+      mImports->functions.insert(mImports->functions.end(), ns.functions().begin(), ns.functions().end());
   }
 
-  return mFunctions;
+  return mImports->functions;
 }
 
 const std::vector<LiteralOperator> & NamespaceScope::literal_operators() const
 {
-  if (mImportedNamespaces.empty())
+  if (imported_namespaces().empty())
     return mNamespace.literalOperators();
 
-  if (mLiteralOperators.empty())
+  std::lock_guard<std::mutex> lock{ mImports->mutex };
+
+  if (mImports->literal_operators.empty())
   {
-    mLiteralOperators = mNamespace.isNull() ? std::vector<LiteralOperator>{} : mNamespace.literalOperators();
-    for (const auto & ns : mImportedNamespaces)
-      mLiteralOperators.insert(mLiteralOperators.end(), ns.literalOperators().begin(), ns.literalOperators().end());
+    mImports->literal_operators = mNamespace.isNull() ? std::vector<LiteralOperator>{} : mNamespace.literalOperators();
+    for (const auto & ns : mImports->namespaces)
+      mImports->literal_operators.insert(mImports->literal_operators.end(), ns.literalOperators().begin(), ns.literalOperators().end());
   }
 
-  return mLiteralOperators;
+  return mImports->literal_operators;
 }
 
 const std::vector<Namespace> & NamespaceScope::namespaces() const
@@ -510,76 +615,126 @@ const std::vector<Namespace> & NamespaceScope::namespaces() const
 
 const std::vector<Operator> & NamespaceScope::operators() const
 {
-  if (mImportedNamespaces.empty())
+  if (imported_namespaces().empty())
     return mNamespace.operators();
 
-  if (mOperators.empty())
+  std::lock_guard<std::mutex> lock{ mImports->mutex };
+
+  if (mImports->operators.empty())
   {
-    mOperators = mNamespace.isNull() ? std::vector<Operator>{} : mNamespace.operators();
-    for (const auto & ns : mImportedNamespaces)
-      mOperators.insert(mOperators.end(), ns.operators().begin(), ns.operators().end());
+    mImports->operators = mNamespace.isNull() ? std::vector<Operator>{} : mNamespace.operators();
+    for (const auto & ns : mImports->namespaces)
+      mImports->operators.insert(mImports->operators.end(), ns.operators().begin(), ns.operators().end());
   }
 
-  return mOperators;
+  return mImports->operators;
 }
 
 const std::vector<Template> & NamespaceScope::templates() const
 {
-  if (mImportedNamespaces.empty())
+  if (imported_namespaces().empty())
     return mNamespace.templates();
 
-  if (mTemplates.empty())
+  std::lock_guard<std::mutex> lock{ mImports->mutex };
+
+  if (mImports->templates.empty())
   {
-    mTemplates = mNamespace.isNull() ? std::vector<Template>{} : mNamespace.templates();
-    for (const auto & ns : mImportedNamespaces)
-      mTemplates.insert(mTemplates.end(), ns.templates().begin(), ns.templates().end());
+    mImports->templates = mNamespace.isNull() ? std::vector<Template>{} : mNamespace.templates();
+    for (const auto & ns : mImports->namespaces)
+      mImports->templates.insert(mImports->templates.end(), ns.templates().begin(), ns.templates().end());
   }
 
-  return mTemplates;
+  return mImports->templates;
 }
 
 const std::vector<Typedef> & NamespaceScope::typedefs() const
 {
-  if (mImportedNamespaces.empty())
+  if (imported_namespaces().empty())
     return mNamespace.typedefs();
 
-  if (mTypedefs.empty())
+  std::lock_guard<std::mutex> lock{ mImports->mutex };
+
+  if (mImports->typedefs.empty())
   {
-    mTypedefs = mNamespace.isNull() ? std::vector<Typedef>{} : mNamespace.typedefs();
-    for (const auto & ns : mImportedNamespaces)
-      mTypedefs.insert(mTypedefs.end(), ns.typedefs().begin(), ns.typedefs().end());
+    mImports->typedefs = mNamespace.isNull() ? std::vector<Typedef>{} : mNamespace.typedefs();
+    for (const auto & ns : mImports->namespaces)
+      mImports->typedefs.insert(mImports->typedefs.end(), ns.typedefs().begin(), ns.typedefs().end());
   }
 
-  return mTypedefs;
+  return mImports->typedefs;
 }
 
 const std::map<std::string, Value> & NamespaceScope::values() const
 {
-  if (mImportedNamespaces.empty())
+  if (imported_namespaces().empty())
     return mNamespace.vars();
 
-  if (mValues.empty())
+  std::lock_guard<std::mutex> lock{ mImports->mutex };
+
+  if (mImports->values.empty())
   {
-    mValues = mNamespace.isNull() ? std::map<std::string, Value>{} : mNamespace.vars();
-    for (const auto & ns : mImportedNamespaces)
+    bool has_values = !mNamespace.isNull() && !mNamespace.vars().empty();
+    for (const auto & ns : mImports->namespaces)
+      has_values = has_values || !ns.vars().empty();
+
+    // copying the values modifies their reference count
+    if (has_values)
+      compiler::ReadOnlyEngine::check();
+
+    mImports->values = mNamespace.isNull() ? std::map<std::string, Value>{} : mNamespace.vars();
+    for (const auto & ns : mImports->namespaces)
     {
       for (const auto & it : ns.vars())
       {
-        mValues[it.first] = it.second;
+        mImports->values[it.first] = it.second;
       }
     }
   }
 
-  return mValues;
+  return mImports->values;
+}
+
+SymbolTable* NamespaceScope::symbols() const
+{
+  if (imported_namespaces().empty())
+    return mNamespace.isNull() ? nullptr : &(mNamespace.impl()->symbols);
+
+  return &mImports->symbols;
+}
+
+const std::vector<Namespace> & NamespaceScope::imported_namespaces() const
+{
+  return mImports == nullptr ? static_dummy_namespaces : mImports->namespaces;
+}
+
+/*!
+ * \fn Imports & imports_for_write()
+ * \brief returns the imports of this scope, copying them if they are shared
+ *
+ * The caches are not copied.
+ */
+NamespaceScope::Imports & NamespaceScope::imports_for_write()
+{
+  if (mImports == nullptr)
+    mImports = std::make_shared<Imports>();
+  else if (mImports.use_count() != 1)
+    mImports = std::make_shared<Imports>(*mImports);
+
+  return *mImports;
 }
 
 void NamespaceScope::import_namespace(const NamespaceScope & other)
 {
+  if (other.mNamespace.isNull() && other.imported_namespaces().empty())
+    return;
+
+  Imports & imports = imports_for_write();
+
   if (!other.mNamespace.isNull())
-    mImportedNamespaces.push_back(other.mNamespace);
+    imports.namespaces.push_back(other.mNamespace);
 
-  for (const auto & ns : other.mImportedNamespaces)
-    mImportedNamespaces.push_back(ns);
+  for (const auto & ns : other.imported_namespaces())
+    imports.namespaces.push_back(ns);
 
   invalidate_cache(Scope::InvalidateAllCaches);
 }
@@ -597,22 +752,30 @@ bool NamespaceScope::lookup(const std::string & name, NameLookupImpl *nl) const
 
 void NamespaceScope::invalidate_cache(int which)
 {
+  if (mImports == nullptr)
+    return;
+
+  std::lock_guard<std::mutex> lock{ mImports->mutex };
+
   if (which & Scope::InvalidateClassCache)
-    mClasses.clear();
+    mImports->classes.clear();
   if (which & Scope::InvalidateEnumCache)
-    mEnums.clear();
+    mImports->enums.clear();
   if (which & Scope::InvalidateFunctionCache)
-    mFunctions.clear();
+    mImports->functions.clear();
   if (which & Scope::InvalidateLiteralOperatorCache)
-    mLiteralOperators.clear();
+    mImports->literal_operators.clear();
   if (which & Scope::InvalidateOperatorCache)
-    mOperators.clear();
+    mImports->operators.clear();
   if (which & Scope::InvalidateTemplateCache)
-    mTemplates.clear();
+    mImports->templates.clear();
   if (which & Scope::InvalidateVariableCache)
-    mValues.clear();
+    mImports->values.clear();
   if (which & Scope::InvalidateTypedefCache)
-    mTypedefs.clear();
+    mImports->typedefs.clear();
+
+  if (which & (Scope::InvalidateClassCache | Scope::InvalidateEnumCache | Scope::InvalidateFunctionCache | Scope::InvalidateOperatorCache | Scope::InvalidateTemplateCache | Scope::InvalidateTypedefCache))
+    mImports->symbols.clear();
 }
 
 
@@ -685,6 +848,11 @@ const std::vector<Typedef> & ClassScope::typedefs() const
   return mClass.typedefs();
 }
 
+SymbolTable* ClassScope::symbols() const
+{
+  return &(mClass.impl()->symbols);
+}
+
 bool ClassScope::lookup(const std::string & name, NameLookupImpl *nl) const
 {
   if (ExtensibleScope::lookup(name, nl))
@@ -718,77 +886,14 @@ bool ClassScope::lookup(const std::string & name, const Class & c, NameLookupImp
     auto it = sdm.find(name);
     if (it != sdm.end())
     {
+      compiler::ReadOnlyEngine::check();
       nl->staticDataMemberResult = it->second;
       nl->memberOfResult = c;
       return true;
     }
   }
 
-  for (const auto & e : c.enums())
-  {
-    if (e.name() == name)
-    {
-      nl->typeResult = e.id();
-      return true;
-    }
-
-    if (e.isEnumClass())
-      continue;
-
-    auto it = e.values().find(name);
-    if (it != e.values().end())
-    {
-      nl->enumeratorResult = Enumerator{ e, it->second };
-      return true;
-    }
-  }
-
-  for (const auto & nested_class : c.classes())
-  {
-    if (nested_class.name() == name)
-    {
-      nl->typeResult = c.id();
-      return true;
-    }
-  }
-
-  for (const auto & td : c.typedefs())
-  {
-    if (td.name() == name)
-    {
-      nl->typeResult = td.type();
-      return true;
-    }
-  }
-
-  bool found_something = false;
-  for (const auto & fn : c.memberFunctions())
-  {
-    if (fn.name() == name)
-    {
-      nl->functions.push_back(fn);
-      found_something = true;
-    }
-  }
-
-  for (const auto & t : c.templates())
-  {
-    if (t.name() == name)
-    {
-      if (t.isClassTemplate())
-      {
-        nl->classTemplateResult = t.asClassTemplate();
-        return true;
-      }
-      else
-      {
-        nl->functionTemplateResult.push_back(t.asFunctionTemplate());
-        found_something = true;
-      }
-    }
-  }
-
-  if (found_something)
+  if (lookup_symbols(name, c.impl()->symbols, c.enums(), c.classes(), c.typedefs(), ScopeImpl::static_dummy_values, c.memberFunctions(), c.templates(), nl))
     return true;
 
   return lookup(name, c.parent(), nl);
@@ -1277,9 +1382,12 @@ Scope Scope::child(const std::string& name) const
   auto nsscope = std::dynamic_pointer_cast<script::NamespaceScope>(d);
   if (nsscope != nullptr)
   {
-    auto it = nsscope->mNamespaceAliases.find(name);
-    if (it != nsscope->mNamespaceAliases.end())
-      return this->child(it->second.nested());
+    if (nsscope->mImports != nullptr)
+    {
+      auto it = nsscope->mImports->aliases.find(name);
+      if (it != nsscope->mImports->aliases.end())
+        return this->child(it->second.nested());
+    }
 
     return Scope{ script::NamespaceScope::child_scope(nsscope, name) };
   }
@@ -1308,25 +1416,40 @@ Scope Scope::child(const std::vector<std::string>& name) const
   return ret;
 }
 
+/*
+ * Copies the nodes of a chain of scopes up to the first node satisfying a predicate,
+ * and returns the copy of that node; the rest of the chain is shared.
+ * Returns nullptr if no node satisfies the predicate, all nodes are then copied.
+ */
+template<typename Pred>
+static std::shared_ptr<ScopeImpl> copy_path(std::shared_ptr<ScopeImpl> & head, Pred pred)
+{
+  std::shared_ptr<ScopeImpl> *link = &head;
+
+  while (*link != nullptr)
+  {
+    auto copy = std::shared_ptr<ScopeImpl>((*link)->clone());
+    *link = copy;
+
+    if (pred(*copy))
+      return copy;
+
+    link = &copy->parent;
+  }
+
+  return nullptr;
+}
+
 /*!
  * \fn void inject(const std::string& name, const script::Type& t)
  * \brief inject a type alias in this scope
  */
 void Scope::inject(const std::string& name, const script::Type& t)
 {
-  if (d->handle_injections())
-  {
-    if (d.use_count() != 1)
-    {
-      d = std::shared_ptr<ScopeImpl>(d->clone());
-    }
+  if (d.use_count() != 1)
+    d = std::shared_ptr<ScopeImpl>(d->clone());
 
-    d->inject(name, t);
-  }
-  else
-  {
-    d->inject(name, t);
-  }
+  d->inject(name, t);
 }
 
 /*!
@@ -1337,19 +1460,7 @@ void Scope::inject(const Class& cla)
 {
   NameLookupImpl lookup;
   lookup.typeResult = cla.id();
-  if (d->handle_injections())
-  {
-    if (d.use_count() != 1)
-    {
-      d = std::shared_ptr<ScopeImpl>(d->clone());
-    }
-
-    d->inject(&lookup);
-  }
-  else
-  {
-    d->inject(&lookup);
-  }
+  inject(&lookup);
 }
 
 /*!
@@ -1360,36 +1471,15 @@ void Scope::inject(const Enum& e)
 {
   NameLookupImpl lookup;
   lookup.typeResult = e.id();
-  if (d->handle_injections())
-  {
-    if (d.use_count() != 1)
-    {
-      d = std::shared_ptr<ScopeImpl>(d->clone());
-    }
-
-    d->inject(&lookup);
-  }
-  else
-  {
-    d->inject(&lookup);
-  }
+  inject(&lookup);
 }
 
 void Scope::inject(const NameLookupImpl *nl)
 {
-  if (d->handle_injections())
-  {
-    if (d.use_count() != 1)
-    {
-      d = std::shared_ptr<ScopeImpl>(d->clone());
-    }
+  if (d.use_count() != 1)
+    d = std::shared_ptr<ScopeImpl>(d->clone());
 
-    d->inject(nl);
-  }
-  else
-  {
-    d->inject(nl);
-  }
+  d->inject(nl);
 }
 
 /*!
@@ -1401,18 +1491,12 @@ void Scope::inject(const Scope& scp)
   if (!scp.isNamespace())
     throw std::runtime_error{ "Cannot inject non-namespace scope" };
 
-  d = std::shared_ptr<ScopeImpl>(d->clone());
-  auto target = d;
-  while (dynamic_cast<script::NamespaceScope*>(target.get()) == nullptr)
-  {
-    if (target->parent == nullptr)
-      throw std::runtime_error{ "Cannot inject namespace scope into non-namespace scope" };
+  auto target = copy_path(d, [](const ScopeImpl& s) { return dynamic_cast<const script::NamespaceScope*>(&s) != nullptr; });
 
-    target = target->parent;
-  }
+  if (target == nullptr)
+    throw std::runtime_error{ "Cannot inject namespace scope into non-namespace scope" };
 
-  script::NamespaceScope *nam_scope = dynamic_cast<script::NamespaceScope*>(target.get());
-  assert(nam_scope != nullptr);
+  script::NamespaceScope *nam_scope = static_cast<script::NamespaceScope*>(target.get());
   nam_scope->import_namespace(dynamic_cast<const script::NamespaceScope &>(*scp.impl()));
 }
 
@@ -1427,7 +1511,8 @@ void Scope::merge(const Scope& scp)
   if (!scp.parent().isNull())
     throw std::runtime_error{ "Scope::merge() : Cannot merge scope with parent" };
 
-  d = std::shared_ptr<ScopeImpl>(d->clone());
+  // all the namespace scopes of the chain may be modified
+  copy_path(d, [](const ScopeImpl&) { return false; });
 
   std::vector<std::shared_ptr<ScopeImpl>> scopes;
   {
@@ -1462,27 +1547,15 @@ void Scope::merge(const Scope& scp)
  */
 void Scope::inject(const NamespaceAlias& alias)
 {
-  d = std::shared_ptr<ScopeImpl>(d->clone());
-  auto target = d;
-  while (target != nullptr)
-  {
-    if (dynamic_cast<script::NamespaceScope*>(target.get()) == nullptr)
-    {
-      target = target->parent;
-      continue;
-    }
+  auto target = copy_path(d, [&alias](const ScopeImpl& s) {
+    auto ns_scope = dynamic_cast<const script::NamespaceScope*>(&s);
+    return ns_scope != nullptr && ns_scope->has_child(alias.nested().front());
+  });
 
-    auto ns_scope = std::dynamic_pointer_cast<script::NamespaceScope>(target);
-    if (ns_scope->has_child(alias.nested().front()))
-    {
-      ns_scope->mNamespaceAliases[alias.name()] = alias;
-      return;
-    }
-
-    target = target->parent;
-  }
+  if (target == nullptr)
+    throw std::runtime_error{ "Scope::inject() : could not inject namespace alias" };
 
-  throw std::runtime_error{ "Scope::inject() : could not inject namespace alias" };
+  static_cast<script::NamespaceScope*>(target.get())->imports_for_write().aliases[alias.name()] = alias;
 }
 
 /*!
@@ -1535,10 +1608,23 @@ std::vector<Function> Scope::lookup(const LiteralOperator&, const std::string& s
 std::vector<Function> Scope::lookup(OperatorName op) const
 {
   std::vector<Function> ret;
-  for (const auto & candidate : operators())
+  const std::vector<Operator> & candidates = operators();
+  SymbolTable *table = d->symbols();
+
+  if (table != nullptr)
+  {
+    table->sync(candidates);
+
+    for (size_t i : table->operators(op))
+      ret.push_back(candidates.at(i));
+  }
+  else
   {
-    if (candidate.operatorId() == op)
-      ret.push_back(candidate);
+    for (const auto & candidate : candidates)
+    {
+      if (candidate.operatorId() == op)
+        ret.push_back(candidate);
+    }
   }
 
   if (ret.empty() && hasParent())
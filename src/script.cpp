@@ -9,8 +9,12 @@
 #include "script/engine.h"
 #include "script/symbol.h"
 
+#include "script/compiler/compiler.h"
+
 #include "script/program/statements.h"
 
+#include <limits>
+
 namespace script
 {
 
@@ -58,6 +62,40 @@ void ScriptImpl::add_breakpoint(script::Function f, std::shared_ptr<program::Bre
 
 }
 
+/*
+ * The ast is needed for instantiating templates and for compiling 
+ * the functions whose compilation was deferred.
+ */
+bool ScriptImpl::ast_locked() const
+{
+  return astlock || !deferred_functions_index.empty();
+}
+
+/*
+ * Releases the ast, and the source for RetentionPolicy::DropAll unless 
+ * the script has attributes.
+ * If some functions are still deferred, the policy is applied once 
+ * they are all compiled.
+ */
+void ScriptImpl::apply_retention_policy(RetentionPolicy policy)
+{
+  if (policy == RetentionPolicy::KeepAll || astlock)
+    return;
+
+  if (!deferred_functions_index.empty())
+  {
+    deferred_retention = policy;
+    return;
+  }
+
+  deferred_retention = RetentionPolicy::KeepAll;
+  ast = nullptr;
+
+  // the attributes reference the source
+  if (policy == RetentionPolicy::DropAll && attributes_source.isNull())
+    source.unload();
+}
+
 /*!
  * \class Script
  */
@@ -100,17 +138,34 @@ void Script::attach(FunctionCreator& fcreator)
 }
 
 /*!
- * \fn bool compile(CompileMode mode, FunctionCreator* fcreator = nullptr)
+ * \fn bool compile(CompileMode mode, FunctionCreator* fcreator = nullptr, RetentionPolicy policy = RetentionPolicy::KeepAll)
  * \brief Compiles the script
  * Returns true on success, false otherwise. 
  * If the compilation failed, use messages() to retrieve the error messages.
+ * On success, the ast and the source are kept or discarded according to \a policy.
  * Warning: Calling this function while a script is compiling is undefined behavior.
  */
-bool Script::compile(CompileMode mode, FunctionCreator* fcreator)
+bool Script::compile(CompileMode mode, FunctionCreator* fcreator, RetentionPolicy policy)
 {
   Engine *e = d->engine;
   d->function_creator = fcreator ? fcreator : d->function_creator;
-  return e->compile(*this, mode);
+  return e->compile(*this, mode, policy);
+}
+
+/*!
+ * \fn bool compileAll()
+ * \brief compiles the functions whose compilation was deferred
+ *
+ * When lazy compilation is enabled, the body of a function is only 
+ * compiled when the function is first called.
+ * This function compiles all the functions that were not called yet, 
+ * and returns false if any of them failed to compile; 
+ * the errors are then available in messages().
+ * \sa compiler::Compiler::setLazyCompilation()
+ */
+bool Script::compileAll()
+{
+  return d->engine->compiler()->compileAll(*this);
 }
 
 /*!
@@ -158,6 +213,9 @@ void Script::clear()
   d->literal_operators.clear();
   d->namespaces.clear();
   d->attributes.clear();
+  d->attributes_arena = nullptr;
+  d->attributes_source = SourceFile{};
+  d->symbols.clear();
 }
 
 /*!
@@ -250,11 +308,12 @@ Ast Script::ast() const
  *
  * Note that this does nothing if the ast is marked as locked.
  * An ast is locked by the implementation when it may be needed later in time; 
- * for example when the script contains templates.
+ * for example when the script contains templates, or functions whose 
+ * compilation was deferred.
  */
 void Script::clearAst()
 {
-  if (d->astlock)
+  if (d->ast_locked())
     return;
 
   d->ast = nullptr;
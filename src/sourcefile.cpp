@@ -5,21 +5,120 @@
 #include "script/sourcefile.h"
 #include "script/private/sourcefile_p.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
-#include <limits>
-#include <sstream>
+#include <iterator>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // !defined(_WIN32)
 
 namespace script
 {
 
 SourceFileImpl::SourceFileImpl(const std::string & path)
   : filepath(path)
+  , mapping(nullptr)
+  , mapping_size(0)
   , open(false)
   , lock(false)
 {
 
 }
 
+SourceFileImpl::~SourceFileImpl()
+{
+  unmap();
+}
+
+/*
+ * The table is built on first use with a single pass over the content, 
+ * afterwards mapping an offset to a line is a binary search.
+ */
+const std::vector<size_t>& SourceFileImpl::lines(const char* data, size_t size)
+{
+  if (!line_offsets.empty())
+    return line_offsets;
+
+  line_offsets.push_back(0);
+
+  const char* begin = data;
+  const char* end = data + size;
+
+  for (const char* it = begin; (it = static_cast<const char*>(std::memchr(it, '\n', end - it))) != nullptr; ++it)
+    line_offsets.push_back(std::distance(begin, it) + 1);
+
+  return line_offsets;
+}
+
+/*
+ * Maps the file in memory, returns false if the file cannot be mapped,
+ * in which case it should be read instead.
+ * Only regular files whose size is not a multiple of the page size are 
+ * mapped: the end of the last page is then filled with zeros, which 
+ * guarantees that the content is null-terminated like a std::string.
+ */
+bool SourceFileImpl::map()
+{
+#if !defined(_WIN32)
+  int fd = ::open(filepath.c_str(), O_RDONLY);
+
+  if (fd == -1)
+    return false;
+
+  struct stat st;
+  const long page_size = ::sysconf(_SC_PAGESIZE);
+
+  if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0 || page_size <= 0 || st.st_size % page_size == 0)
+  {
+    ::close(fd);
+    return false;
+  }
+
+  void *addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+
+  if (addr == MAP_FAILED)
+    return false;
+
+  mapping = static_cast<const char*>(addr);
+  mapping_size = static_cast<size_t>(st.st_size);
+  return true;
+#else
+  return false;
+#endif // !defined(_WIN32)
+}
+
+void SourceFileImpl::unmap()
+{
+#if !defined(_WIN32)
+  if (mapping != nullptr)
+    ::munmap(const_cast<char*>(mapping), mapping_size);
+#endif // !defined(_WIN32)
+
+  mapping = nullptr;
+  mapping_size = 0;
+}
+
+/*
+ * Replaces the mapping by a copy of the content of the file.
+ * A mapping reflects later changes to the file (and accessing it may 
+ * fail if the file shrinks), so content that outlives its use, such 
+ * as the source of a script, must be copied before it is parsed.
+ */
+void SourceFileImpl::copy_mapping()
+{
+  if (mapping == nullptr)
+    return;
+
+  content.assign(mapping, mapping_size);
+  unmap();
+}
+
 /*!
  * \class SourceFile
  */
@@ -75,35 +174,14 @@ SourceFile::Position SourceFile::map(Offset off) const
   Position result;
   result.pos = off;
 
-  if (off <= 0)
-  {
-    result.line = 0;
-    result.col = 0;
-    return result;
-  }
-
-  size_t p = off;
-
-  while (p-- > 0 && d->content[p] != '\n');
-
-  if (p == std::numeric_limits<size_t>::max())
-  {
-    result.line = 0;
-    result.col = static_cast<decltype(result.col)>(off);
-    return result;
-  }
-  else
-  {
-    result.col = static_cast<decltype(result.col)>(off - 1 - p);
-  }
+  const std::vector<size_t>& lines = d->lines(data(), size());
 
-  result.line = 0;
+  // the line is the last one starting at or before 'off'
+  auto it = std::upper_bound(lines.begin(), lines.end(), off);
+  const size_t line = std::distance(lines.begin(), it) - 1;
 
-  for (size_t i(0); i <= p; ++i)
-  {
-    if (d->content[i] == '\n')
-      result.line += 1;
-  }
+  result.line = static_cast<decltype(result.line)>(line);
+  result.col = static_cast<decltype(result.col)>(off - lines.at(line));
 
   return result;
 }
@@ -114,6 +192,10 @@ SourceFile::Position SourceFile::map(Offset off) const
  *
  * This does nothing if the sourcefile is already loaded or if it was 
  * created from an in-memory string.
+ * Regular files are memory-mapped when the platform allows it, other files 
+ * are read into memory.
+ * The source of a script is copied when the script is compiled, so that 
+ * later changes to the file do not affect it.
  * Throws std::runtime_error on failure.
  */
 void SourceFile::load()
@@ -124,14 +206,18 @@ void SourceFile::load()
   if (d->filepath.empty())
     throw std::runtime_error{ "SourceFile not associated with a local file" };
 
-  std::ifstream file{ d->filepath };
-  if (!file.is_open())
-    throw std::runtime_error{ "Could not open file ..." };
+  d->line_offsets.clear();
+
+  if (!d->map())
+  {
+    std::ifstream file{ d->filepath, std::ios::binary };
+    if (!file.is_open())
+      throw std::runtime_error{ "Could not open file ..." };
+
+    d->content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
 
-  std::stringstream stream;
-  stream << file.rdbuf();
-  d->content = stream.str();
-  file.close();
+  d->open = true;
 }
 
 /*!
@@ -168,7 +254,9 @@ void SourceFile::unload()
   if (d->lock)
     return;
 
+  d->unmap();
   d->content = std::string{};
+  d->line_offsets.clear();
   d->open = false;
 }
 
@@ -179,7 +267,17 @@ void SourceFile::unload()
  */
 const char * SourceFile::data() const
 {
-  return d->content.data();
+  return d->mapping != nullptr ? d->mapping : d->content.data();
+}
+
+/*!
+ * \fn size_t size() const
+ * \brief Returns the size of the source file content.
+ *
+ */
+size_t SourceFile::size() const
+{
+  return d->mapping != nullptr ? d->mapping_size : d->content.size();
 }
 
 /*!
@@ -187,9 +285,14 @@ const char * SourceFile::data() const
  * \brief Returns the source file content.
  *
  * If the source file is not loaded, the string is empty.
+ * If the file is memory-mapped, the first call to this function copies 
+ * the content into a string; prefer \m data and \m size.
  */
 const std::string & SourceFile::content() const
 {
+  if (d->mapping != nullptr && d->content.empty())
+    d->content.assign(d->mapping, d->mapping_size);
+
   return d->content;
 }
 
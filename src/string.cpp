@@ -49,9 +49,9 @@ Value char_ctor(FunctionCall *c)
 // ~String();
 Value dtor(FunctionCall *c)
 {
-  Value that = c->thisObject();
-  script::get<String>(that).clear();
-  return that;
+  // the storage is released together with the Value, which may 
+  // outlive the String if StringViews still refer to it
+  return c->thisObject();
 }
 
 // char String::at(int index) const;
@@ -257,6 +257,114 @@ Value subscript(FunctionCall *c)
 
 } // namespace string
 
+namespace stringbuilder
+{
+
+// StringBuilder();
+Value default_ctor(FunctionCall *c)
+{
+  c->thisObject().init<StringBuilder>();
+  return c->thisObject();
+}
+
+// StringBuilder(const StringBuilder & other);
+Value copy_ctor(FunctionCall *c)
+{
+  c->thisObject().init<StringBuilder>(script::get<StringBuilder>(c->arg(1)));
+  return c->thisObject();
+}
+
+// ~StringBuilder();
+Value dtor(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  script::get<StringBuilder>(that).clear();
+  return that;
+}
+
+// StringBuilder & StringBuilder::append(const String & str);
+Value append_string(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  auto& self = script::get<StringBuilder>(that);
+
+  self.append(script::get<String>(c->arg(1)));
+
+  return that;
+}
+
+// StringBuilder & StringBuilder::append(char c);
+Value append_char(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  auto& self = script::get<StringBuilder>(that);
+
+  self.append(c->arg(1).toChar());
+
+  return that;
+}
+
+// int StringBuilder::capacity() const;
+Value capacity(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  return c->engine()->newInt(static_cast<int>(script::get<StringBuilder>(that).capacity()));
+}
+
+// void StringBuilder::clear();
+Value clear(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  script::get<StringBuilder>(that).clear();
+  return Value::Void;
+}
+
+// void StringBuilder::reserve(int n);
+Value reserve(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  auto& self = script::get<StringBuilder>(that);
+
+  const int n = c->arg(1).toInt();
+
+  if (n > 0)
+    self.reserve(static_cast<size_t>(n));
+
+  return Value::Void;
+}
+
+// int StringBuilder::size() const;
+Value size(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  return c->engine()->newInt(static_cast<int>(script::get<StringBuilder>(that).size()));
+}
+
+// String StringBuilder::toString() const;
+Value to_string(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  return c->engine()->newString(script::get<StringBuilder>(that).toString());
+}
+
+namespace operators
+{
+
+// StringBuilder & StringBuilder::operator=(const StringBuilder & other);
+Value assign(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  auto& self = script::get<StringBuilder>(that);
+
+  self = script::get<StringBuilder>(c->arg(1));
+
+  return that;
+}
+
+} // namespace operators
+
+} // namespace stringbuilder
+
 } // namespace callbacks
 
 void StringBackend::register_string_type(Class& string)
@@ -294,6 +402,24 @@ void StringBackend::register_string_type(Class& string)
   FunctionBuilder::Op(string, SubscriptOperator).setCallback(callbacks::string::operators::subscript).returns(Type::ref(Type::Char)).params(Type::Int).create();
 }
 
+void StringBackend::register_string_builder_type(Class& builder)
+{
+  FunctionBuilder::Constructor(builder).setCallback(callbacks::stringbuilder::default_ctor).create();
+  FunctionBuilder::Constructor(builder).setCallback(callbacks::stringbuilder::copy_ctor).params(Type::cref(builder.id())).create();
+
+  FunctionBuilder::Destructor(builder).setCallback(callbacks::stringbuilder::dtor).create();
+
+  FunctionBuilder::Fun(builder, "append").setCallback(callbacks::stringbuilder::append_string).returns(Type::ref(builder.id())).params(Type::cref(Type::String)).create();
+  FunctionBuilder::Fun(builder, "append").setCallback(callbacks::stringbuilder::append_char).returns(Type::ref(builder.id())).params(Type::Char).create();
+  FunctionBuilder::Fun(builder, "capacity").setCallback(callbacks::stringbuilder::capacity).setConst().returns(Type::Int).create();
+  FunctionBuilder::Fun(builder, "clear").setCallback(callbacks::stringbuilder::clear).create();
+  FunctionBuilder::Fun(builder, "reserve").setCallback(callbacks::stringbuilder::reserve).params(Type::Int).create();
+  FunctionBuilder::Fun(builder, "size").setCallback(callbacks::stringbuilder::size).setConst().returns(Type::Int).create();
+  FunctionBuilder::Fun(builder, "toString").setCallback(callbacks::stringbuilder::to_string).setConst().returns(Type::String).create();
+
+  FunctionBuilder::Op(builder, AssignmentOperator).setCallback(callbacks::stringbuilder::operators::assign).returns(Type::ref(builder.id())).params(Type::cref(builder.id())).create();
+}
+
 } // namespace script
 
 #endif // defined(LIBSCRIPT_USE_BUILTIN_STRING_BACKEND)
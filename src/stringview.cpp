@@ -0,0 +1,414 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "script/stringview.h"
+
+#if defined(LIBSCRIPT_USE_BUILTIN_STRING_BACKEND)
+
+#include "script/array.h"
+#include "script/engine.h"
+#include "script/class.h"
+#include "script/functionbuilder.h"
+
+#include "script/interpreter/executioncontext.h"
+#include "script/private/array_p.h"
+#include "script/private/value_p.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace script
+{
+
+/*!
+ * \class StringView
+ */
+
+StringView::StringView()
+  : m_offset(0),
+    m_size(0)
+{
+
+}
+
+/*!
+ * \fn StringView(const Value& str)
+ * \brief constructs a view on a whole String
+ */
+StringView::StringView(const Value& str)
+  : m_source(str),
+    m_offset(0),
+    m_size(npos)
+{
+
+}
+
+/*!
+ * \fn StringView(const Value& str, size_t pos, size_t count)
+ * \brief constructs a view on at most \a count characters of a String starting at \a pos
+ */
+StringView::StringView(const Value& str, size_t pos, size_t count)
+  : m_source(str),
+    m_offset(pos),
+    m_size(count)
+{
+
+}
+
+/*!
+ * \fn utils::StringView view() const
+ * \brief returns the characters currently covered by this view
+ */
+utils::StringView StringView::view() const
+{
+  if (m_source.isNull())
+    return utils::StringView();
+
+  const String& str = script::get<String>(m_source);
+  const size_t off = std::min(m_offset, str.size());
+  const size_t n = std::min(m_size, str.size() - off);
+  return utils::StringView(str.data() + off, n);
+}
+
+/*!
+ * \fn char at(size_t index) const
+ * \brief returns the character at position \a index
+ *
+ * Throws std::out_of_range if \a index is not less than size(), 
+ * like String::at().
+ */
+char StringView::at(size_t index) const
+{
+  utils::StringView v = view();
+
+  if (index >= v.size())
+    throw std::out_of_range{ "StringView::at" };
+
+  return v.at(index);
+}
+
+/*!
+ * \fn size_t find(const utils::StringView& str, size_t pos) const
+ * \brief returns the position of the first occurrence of \a str at or after \a pos
+ *
+ * Returns \c npos if \a str is not found.
+ */
+size_t StringView::find(const utils::StringView& str, size_t pos) const
+{
+  const utils::StringView self = view();
+
+  if (pos > self.size() || str.size() > self.size() - pos)
+    return npos;
+
+  const char* begin = self.data() + pos;
+  const char* end = self.data() + self.size();
+  const char* it = std::search(begin, end, str.data(), str.data() + str.size());
+
+  return it == end && str.size() > 0 ? npos : static_cast<size_t>(it - self.data());
+}
+
+/*!
+ * \fn StringView substr(size_t pos, size_t count) const
+ * \brief returns a view on a subrange of this view
+ *
+ * The returned view shares the source String of this view.
+ */
+StringView StringView::substr(size_t pos, size_t count) const
+{
+  const size_t s = size();
+  pos = std::min(pos, s);
+  count = std::min(count, s - pos);
+  return StringView(m_source, m_offset + pos, count);
+}
+
+/*!
+ * \fn int compare(const utils::StringView& other) const
+ * \brief lexicographically compares this view with \a other
+ */
+int StringView::compare(const utils::StringView& other) const
+{
+  const utils::StringView self = view();
+  const size_t n = std::min(self.size(), other.size());
+
+  const int r = n == 0 ? 0 : std::memcmp(self.data(), other.data(), n);
+
+  if (r != 0)
+    return r < 0 ? -1 : 1;
+  else if (self.size() == other.size())
+    return 0;
+
+  return self.size() < other.size() ? -1 : 1;
+}
+
+/*!
+ * \fn bool starts_with(const utils::StringView& str) const
+ * \brief returns whether this view starts with \a str
+ */
+bool StringView::starts_with(const utils::StringView& str) const
+{
+  const utils::StringView self = view();
+  return str.size() <= self.size() && std::memcmp(self.data(), str.data(), str.size()) == 0;
+}
+
+/*!
+ * \fn bool ends_with(const utils::StringView& str) const
+ * \brief returns whether this view ends with \a str
+ */
+bool StringView::ends_with(const utils::StringView& str) const
+{
+  const utils::StringView self = view();
+  return str.size() <= self.size() && std::memcmp(self.data() + self.size() - str.size(), str.data(), str.size()) == 0;
+}
+
+/*!
+ * \fn std::vector<StringView> split(char sep) const
+ * \brief splits this view around each occurrence of \a sep
+ */
+std::vector<StringView> StringView::split(char sep) const
+{
+  std::vector<StringView> result;
+
+  const utils::StringView self = view();
+  size_t start = 0;
+
+  for (size_t i(0); i < self.size(); ++i)
+  {
+    if (self.at(i) == sep)
+    {
+      result.push_back(StringView(m_source, m_offset + start, i - start));
+      start = i + 1;
+    }
+  }
+
+  result.push_back(StringView(m_source, m_offset + start, self.size() - start));
+
+  return result;
+}
+
+/*!
+ * \endclass
+ */
+
+namespace callbacks
+{
+
+namespace stringview
+{
+
+static utils::StringView view_arg(FunctionCall *c, int i)
+{
+  return script::get<StringView>(c->arg(i)).view();
+}
+
+// StringView();
+Value default_ctor(FunctionCall *c)
+{
+  c->thisObject().init<StringView>();
+  return c->thisObject();
+}
+
+// StringView(const StringView & other);
+Value copy_ctor(FunctionCall *c)
+{
+  c->thisObject().init<StringView>(script::get<StringView>(c->arg(1)));
+  return c->thisObject();
+}
+
+// StringView(const String & str);
+Value string_ctor(FunctionCall *c)
+{
+  c->thisObject().init<StringView>(c->arg(1));
+  return c->thisObject();
+}
+
+// ~StringView();
+Value dtor(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  script::get<StringView>(that) = StringView();
+  return that;
+}
+
+// char StringView::at(int index) const;
+Value at(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  const auto& self = script::get<StringView>(that);
+
+  const int position = c->arg(1).toInt();
+
+  // a negative position converts to an index that is out of range
+  return c->engine()->newChar(self.at(static_cast<size_t>(position)));
+}
+
+// int StringView::compare(const StringView & other) const;
+Value compare(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  const auto& self = script::get<StringView>(that);
+  return c->engine()->newInt(self.compare(view_arg(c, 1)));
+}
+
+// bool StringView::empty() const;
+Value empty(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  return c->engine()->newBool(script::get<StringView>(that).empty());
+}
+
+// bool StringView::ends_with(const StringView & str) const;
+Value ends_with(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  const auto& self = script::get<StringView>(that);
+  return c->engine()->newBool(self.ends_with(view_arg(c, 1)));
+}
+
+// int StringView::find(const StringView & str) const;
+// int StringView::find(const StringView & str, int pos) const;
+Value find(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  const auto& self = script::get<StringView>(that);
+
+  const int pos = c->argc() > 2 ? c->arg(2).toInt() : 0;
+
+  if (pos < 0)
+    return c->engine()->newInt(-1);
+
+  const size_t result = self.find(view_arg(c, 1), static_cast<size_t>(pos));
+
+  return c->engine()->newInt(result == StringView::npos ? -1 : static_cast<int>(result));
+}
+
+// int StringView::length() const;
+// int StringView::size() const;
+Value length(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  return c->engine()->newInt(static_cast<int>(script::get<StringView>(that).size()));
+}
+
+// Array<StringView> StringView::split(char sep) const;
+Value split(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  const auto& self = script::get<StringView>(that);
+
+  std::vector<StringView> parts = self.split(c->arg(1).toChar());
+
+  Array result = c->engine()->newArray(Engine::ElementType{ c->callee().memberOf().id() });
+  auto aimpl = result.impl();
+  aimpl->allocate(static_cast<int>(parts.size()));
+
+  for (size_t i(0); i < parts.size(); ++i)
+    aimpl->elements[i] = c->engine()->construct<StringView>(std::move(parts[i]));
+
+  return Value::fromArray(result);
+}
+
+// bool StringView::starts_with(const StringView & str) const;
+Value starts_with(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  const auto& self = script::get<StringView>(that);
+  return c->engine()->newBool(self.starts_with(view_arg(c, 1)));
+}
+
+// StringView StringView::substr(int pos, int n) const;
+Value substr(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  const auto& self = script::get<StringView>(that);
+
+  const int pos = std::max(c->arg(1).toInt(), 0);
+  const int n = c->arg(2).toInt();
+
+  StringView result = self.substr(static_cast<size_t>(pos), n < 0 ? StringView::npos : static_cast<size_t>(n));
+
+  return c->engine()->construct<StringView>(std::move(result));
+}
+
+// String StringView::toString() const;
+Value to_string(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  return c->engine()->newString(script::get<StringView>(that).toString());
+}
+
+namespace operators
+{
+
+// StringView & StringView::operator=(const StringView & other);
+Value assign(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  auto& self = script::get<StringView>(that);
+
+  self = script::get<StringView>(c->arg(1));
+
+  return that;
+}
+
+// bool StringView::operator==(const StringView & other) const;
+Value eq(FunctionCall *c)
+{
+  return c->engine()->newBool(view_arg(c, 0) == view_arg(c, 1));
+}
+
+// bool StringView::operator!=(const StringView & other) const;
+Value neq(FunctionCall *c)
+{
+  return c->engine()->newBool(view_arg(c, 0) != view_arg(c, 1));
+}
+
+// bool StringView::operator<(const StringView & other) const;
+Value less(FunctionCall *c)
+{
+  Value that = c->thisObject();
+  const auto& self = script::get<StringView>(that);
+  return c->engine()->newBool(self.compare(view_arg(c, 1)) < 0);
+}
+
+} // namespace operators
+
+} // namespace stringview
+
+} // namespace callbacks
+
+void StringBackend::register_string_view_type(Class& view)
+{
+  Engine* e = view.engine();
+
+  FunctionBuilder::Constructor(view).setCallback(callbacks::stringview::default_ctor).create();
+  FunctionBuilder::Constructor(view).setCallback(callbacks::stringview::copy_ctor).params(Type::cref(view.id())).create();
+  FunctionBuilder::Constructor(view).setCallback(callbacks::stringview::string_ctor).params(Type::cref(Type::String)).create();
+
+  FunctionBuilder::Destructor(view).setCallback(callbacks::stringview::dtor).create();
+
+  const Type array_type = e->newArray(Engine::ElementType{ view.id() }).typeId();
+
+  FunctionBuilder::Fun(view, "at").setCallback(callbacks::stringview::at).setConst().returns(Type::Char).params(Type::Int).create();
+  FunctionBuilder::Fun(view, "compare").setCallback(callbacks::stringview::compare).setConst().returns(Type::Int).params(Type::cref(view.id())).create();
+  FunctionBuilder::Fun(view, "empty").setCallback(callbacks::stringview::empty).setConst().returns(Type::Boolean).create();
+  FunctionBuilder::Fun(view, "ends_with").setCallback(callbacks::stringview::ends_with).setConst().returns(Type::Boolean).params(Type::cref(view.id())).create();
+  FunctionBuilder::Fun(view, "find").setCallback(callbacks::stringview::find).setConst().returns(Type::Int).params(Type::cref(view.id())).create();
+  FunctionBuilder::Fun(view, "find").setCallback(callbacks::stringview::find).setConst().returns(Type::Int).params(Type::cref(view.id()), Type::Int).create();
+  FunctionBuilder::Fun(view, "length").setCallback(callbacks::stringview::length).setConst().returns(Type::Int).create();
+  FunctionBuilder::Fun(view, "size").setCallback(callbacks::stringview::length).setConst().returns(Type::Int).create();
+  FunctionBuilder::Fun(view, "split").setCallback(callbacks::stringview::split).setConst().returns(array_type).params(Type::Char).create();
+  FunctionBuilder::Fun(view, "starts_with").setCallback(callbacks::stringview::starts_with).setConst().returns(Type::Boolean).params(Type::cref(view.id())).create();
+  FunctionBuilder::Fun(view, "substr").setCallback(callbacks::stringview::substr).setConst().returns(view.id()).params(Type::Int, Type::Int).create();
+  FunctionBuilder::Fun(view, "toString").setCallback(callbacks::stringview::to_string).setConst().returns(Type::String).create();
+
+  FunctionBuilder::Op(view, AssignmentOperator).setCallback(callbacks::stringview::operators::assign).returns(Type::ref(view.id())).params(Type::cref(view.id())).create();
+  FunctionBuilder::Op(view, EqualOperator).setCallback(callbacks::stringview::operators::eq).setConst().returns(Type::Boolean).params(Type::cref(view.id())).create();
+  FunctionBuilder::Op(view, InequalOperator).setCallback(callbacks::stringview::operators::neq).setConst().returns(Type::Boolean).params(Type::cref(view.id())).create();
+  FunctionBuilder::Op(view, LessOperator).setCallback(callbacks::stringview::operators::less).setConst().returns(Type::Boolean).params(Type::cref(view.id())).create();
+  FunctionBuilder::Op(view, SubscriptOperator).setCallback(callbacks::stringview::at).setConst().returns(Type::Char).params(Type::Int).create();
+}
+
+} // namespace script
+
+#endif // defined(LIBSCRIPT_USE_BUILTIN_STRING_BACKEND)
@@ -0,0 +1,168 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "script/private/symboltable_p.h"
+
+namespace script
+{
+
+SymbolTable::SymbolTable(const SymbolTable & other)
+{
+  *this = other;
+}
+
+SymbolTable & SymbolTable::operator=(const SymbolTable & other)
+{
+  if (this == &other)
+    return *this;
+
+  std::lock(m_mutex, other.m_mutex);
+  std::lock_guard<std::mutex> lock{ m_mutex, std::adopt_lock };
+  std::lock_guard<std::mutex> other_lock{ other.m_mutex, std::adopt_lock };
+
+  m_entries = other.m_entries;
+  m_enums = other.m_enums;
+  m_classes = other.m_classes;
+  m_typedefs = other.m_typedefs;
+  m_functions = other.m_functions;
+  m_templates = other.m_templates;
+  m_operators = other.m_operators;
+  m_fundamental_operators = other.m_fundamental_operators;
+  m_operator_count = other.m_operator_count;
+
+  return *this;
+}
+
+template<typename T>
+static void symboltable_index(std::unordered_map<std::string, SymbolTable::Entry> & entries, const std::vector<T> & list, size_t & count, std::vector<size_t> SymbolTable::Entry::*member)
+{
+  for (; count < list.size(); ++count)
+    (entries[list.at(count).name()].*member).push_back(count);
+}
+
+/*!
+ * \fn void sync(const std::vector<Enum> & enums, const std::vector<Class> & classes, const std::vector<Typedef> & typedefs, const std::vector<Function> & functions, const std::vector<Template> & templates)
+ * \brief indexes the symbols that were added since the last call
+ *
+ * If one of the lists shrank, the table is rebuilt from scratch.
+ */
+void SymbolTable::sync(const std::vector<Enum> & enums, const std::vector<Class> & classes, const std::vector<Typedef> & typedefs,
+  const std::vector<Function> & functions, const std::vector<Template> & templates)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+
+  if (enums.size() == m_enums && classes.size() == m_classes && typedefs.size() == m_typedefs
+    && functions.size() == m_functions && templates.size() == m_templates)
+    return;
+
+  if (enums.size() < m_enums || classes.size() < m_classes || typedefs.size() < m_typedefs
+    || functions.size() < m_functions || templates.size() < m_templates)
+    reset();
+
+  symboltable_index(m_entries, enums, m_enums, &Entry::enums);
+  symboltable_index(m_entries, classes, m_classes, &Entry::classes);
+  symboltable_index(m_entries, typedefs, m_typedefs, &Entry::typedefs);
+  symboltable_index(m_entries, functions, m_functions, &Entry::functions);
+  symboltable_index(m_entries, templates, m_templates, &Entry::templates);
+}
+
+/*!
+ * \fn const Entry* find(const std::string & name) const
+ * \brief returns the positions of the symbols with the given name
+ *
+ * Returns nullptr if no symbol has this name.
+ */
+const SymbolTable::Entry* SymbolTable::find(const std::string & name) const
+{
+  auto it = m_entries.find(name);
+  return it != m_entries.end() ? &(it->second) : nullptr;
+}
+
+static uint64_t symboltable_operator_key(OperatorName op, const Type & lhs, const Type & rhs)
+{
+  return (static_cast<uint64_t>(op) << 40) | (static_cast<uint64_t>(lhs.baseType().data()) << 20) | static_cast<uint64_t>(rhs.baseType().data());
+}
+
+/*!
+ * \fn void sync(const std::vector<Operator> & operators)
+ * \brief indexes the operators that were added since the last call
+ */
+void SymbolTable::sync(const std::vector<Operator> & operators)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+
+  if (operators.size() < m_operator_count)
+  {
+    m_operators.clear();
+    m_fundamental_operators.clear();
+    m_operator_count = 0;
+  }
+
+  for (; m_operator_count < operators.size(); ++m_operator_count)
+  {
+    const Operator & op = operators.at(m_operator_count);
+    const size_t id = static_cast<size_t>(op.operatorId());
+
+    if (m_operators.size() <= id)
+      m_operators.resize(id + 1);
+
+    m_operators[id].push_back(m_operator_count);
+
+    const Prototype & proto = op.prototype();
+    if (proto.count() == 2 && proto.at(0).isFundamentalType() && proto.at(1).isFundamentalType())
+      m_fundamental_operators[symboltable_operator_key(op.operatorId(), proto.at(0), proto.at(1))].push_back(m_operator_count);
+  }
+}
+
+/*!
+ * \fn const std::vector<size_t> & operators(OperatorName op) const
+ * \brief returns the positions of the operators with the given name
+ */
+const std::vector<size_t> & SymbolTable::operators(OperatorName op) const
+{
+  static const std::vector<size_t> static_empty_list = {};
+  const size_t id = static_cast<size_t>(op);
+  return id < m_operators.size() ? m_operators[id] : static_empty_list;
+}
+
+/*!
+ * \fn const std::vector<size_t> & operators(OperatorName op, const Type & lhs, const Type & rhs) const
+ * \brief returns the positions of the operators taking two fundamental types
+ *
+ * Operators are matched on the base type of their parameters, const and 
+ * reference qualifiers are ignored.
+ */
+const std::vector<size_t> & SymbolTable::operators(OperatorName op, const Type & lhs, const Type & rhs) const
+{
+  static const std::vector<size_t> static_empty_list = {};
+  auto it = m_fundamental_operators.find(symboltable_operator_key(op, lhs, rhs));
+  return it != m_fundamental_operators.end() ? it->second : static_empty_list;
+}
+
+/*!
+ * \fn void clear()
+ * \brief clears the table
+ *
+ * This must be called whenever the indexed lists are cleared.
+ */
+void SymbolTable::clear()
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  reset();
+}
+
+void SymbolTable::reset()
+{
+  m_entries.clear();
+  m_enums = 0;
+  m_classes = 0;
+  m_typedefs = 0;
+  m_functions = 0;
+  m_templates = 0;
+  m_operators.clear();
+  m_fundamental_operators.clear();
+  m_operator_count = 0;
+}
+
+} // namespace script
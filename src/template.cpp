@@ -193,6 +193,34 @@ bool TemplateArgumentComparison::operator()(const std::vector<TemplateArgument>&
   return false; // a == b
 }
 
+size_t TemplateArgumentHash::operator()(const TemplateArgument& arg) const
+{
+  size_t h = static_cast<size_t>(arg.kind);
+
+  switch (arg.kind)
+  {
+  case TemplateArgument::BoolArgument:
+    return h * 31 + static_cast<size_t>(arg.boolean);
+  case TemplateArgument::IntegerArgument:
+    return h * 31 + static_cast<size_t>(arg.integer);
+  case TemplateArgument::TypeArgument:
+    return h * 31 + static_cast<size_t>(arg.type.data());
+  case TemplateArgument::PackArgument:
+    return h * 31 + (*this)(arg.pack->args());
+  default:
+    return h;
+  }
+}
+
+size_t TemplateArgumentHash::operator()(const std::vector<TemplateArgument>& args) const
+{
+  size_t h = args.size();
+
+  for (const TemplateArgument& a : args)
+    h = h * 31 + (*this)(a);
+
+  return h;
+}
 
 bool operator==(const TemplateArgument& lhs, const TemplateArgument& rhs)
 {
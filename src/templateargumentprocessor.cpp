@@ -13,6 +13,7 @@
 #include "script/compiler/compilererrors.h"
 #include "script/compiler/literalprocessor.h"
 #include "script/compiler/nameresolver.h"
+#include "script/compiler/readonlyengine.h"
 #include "script/compiler/typeresolver.h"
 
 #include "script/ast/node.h"
@@ -64,9 +65,11 @@ std::vector<TemplateArgument> TemplateArgumentProcessor::arguments(const Scope &
 
 Class TemplateArgumentProcessor::instantiate(ClassTemplate & ct, const std::vector<TemplateArgument> & args)
 {
+  compiler::ReadOnlyEngine::check();
+
   ClassTemplateInstanceBuilder builder{ ct, std::vector<TemplateArgument>{ args} };
   Class ret = ct.backend()->instantiate(builder);
-  ct.impl()->instances[args] = ret;
+  ct.impl()->instances.insert(args, ret);
   return ret;
 }
 
@@ -11,6 +11,8 @@
 #include "script/namelookup.h"
 #include "script/scope.h"
 
+#include "script/compiler/readonlyengine.h"
+
 #include "script/private/class_p.h"
 #include "script/private/engine_p.h"
 #include "script/private/enum_p.h"
@@ -18,6 +20,8 @@
 #include "script/private/operator_p.h"
 #include "script/private/value_p.h"
 
+#include <limits>
+
 namespace script
 {
 
@@ -39,6 +43,93 @@ Value function_variable_assignment(interpreter::FunctionCall* c)
 
 } // namespace callbacks
 
+uint64_t ConversionCache::key(const Type& src, const Type& dest)
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(src.data())) << 32) | static_cast<uint32_t>(dest.data());
+}
+
+bool ConversionCache::find(const Type& src, const Type& dest, int policy, Conversion& result) const
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  const auto& table = m_conversions[policy];
+  auto it = table.find(key(src, dest));
+
+  if (it == table.end())
+    return false;
+
+  result = it->second;
+  return true;
+}
+
+void ConversionCache::insert(const Type& src, const Type& dest, int policy, const Conversion& result)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  m_conversions[policy][key(src, dest)] = result;
+}
+
+bool ConversionCache::find(const Type& src, const Type& dest, StandardConversion& result) const
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  auto it = m_standard_conversions.find(key(src, dest));
+
+  if (it == m_standard_conversions.end())
+    return false;
+
+  result = it->second;
+  return true;
+}
+
+void ConversionCache::insert(const Type& src, const Type& dest, const StandardConversion& result)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  m_standard_conversions[key(src, dest)] = result;
+}
+
+void ConversionCache::clear()
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  m_conversions[Conversion::NoExplicitConversions].clear();
+  m_conversions[Conversion::AllowExplicitConversions].clear();
+  m_standard_conversions.clear();
+}
+
+size_t ConversionCache::size() const
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  return m_conversions[0].size() + m_conversions[1].size() + m_standard_conversions.size();
+}
+
+template<typename T>
+static void erase_conversions(std::unordered_map<uint64_t, T>& conversions, const Type& t)
+{
+  const Type base = t.baseType();
+
+  for (auto it = conversions.begin(); it != conversions.end();)
+  {
+    const Type src{ static_cast<int>(it->first >> 32) };
+    const Type dest{ static_cast<int>(it->first & 0xFFFFFFFF) };
+
+    if (src.baseType() == base || dest.baseType() == base)
+      it = conversions.erase(it);
+    else
+      ++it;
+  }
+}
+
+void ConversionCache::created(const Type&)
+{
+  // a new type does not change the conversions between existing types
+}
+
+void ConversionCache::destroyed(const Type& t)
+{
+  // the id of the type may be reused
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  erase_conversions(m_conversions[Conversion::NoExplicitConversions], t);
+  erase_conversions(m_conversions[Conversion::AllowExplicitConversions], t);
+  erase_conversions(m_standard_conversions, t);
+}
+
 TypeSystemImpl::TypeSystemImpl(Engine *e)
   : engine(e)
 {
@@ -93,6 +184,8 @@ void TypeSystemImpl::reserveTypes()
 
 ClosureType TypeSystemImpl::newLambda()
 {
+  compiler::ReadOnlyEngine::check();
+
   const int id = static_cast<int>(this->lambdas.size()) | Type::LambdaFlag;
   // const int index = id & 0xFFFF;
   ClosureType l{ std::make_shared<ClosureTypeImpl>(id, this->engine) };
@@ -103,6 +196,8 @@ ClosureType TypeSystemImpl::newLambda()
 
 void TypeSystemImpl::register_class(Class & c, int id)
 {
+  compiler::ReadOnlyEngine::check();
+
   if (id < 1)
   {
     id = static_cast<int>(this->classes.size()) | Type::ObjectFlag;
@@ -134,6 +229,8 @@ void TypeSystemImpl::register_class(Class & c, int id)
 
 void TypeSystemImpl::register_enum(Enum & e, int id)
 {
+  compiler::ReadOnlyEngine::check();
+
   if (id < 1)
   {
     id = static_cast<int>(this->enums.size()) | Type::EnumFlag;
@@ -215,6 +312,9 @@ void TypeSystemImpl::destroy(Class c)
   impl->casts.clear();
   impl->templates.clear(); /// TODO: clear the template instances
   impl->typedefs.clear();
+  impl->symbols.clear();
+
+  engine->implementation()->overload_resolution_cache.invalidate();
 
   unregister_class(c);
 
@@ -256,6 +356,8 @@ void TypeSystemImpl::unregister_function(FunctionType& ft)
 
 void TypeSystemImpl::notify_creation(const Type& t)
 {
+  conversions.created(t);
+
   for (const auto& l : listeners)
   {
     l->created(t);
@@ -264,6 +366,8 @@ void TypeSystemImpl::notify_creation(const Type& t)
 
 void TypeSystemImpl::notify_destruction(const Type& t)
 {
+  conversions.destroyed(t);
+
   for (const auto& l : listeners)
   {
     l->destroyed(t);
@@ -396,6 +500,8 @@ FunctionType TypeSystem::getFunctionType(const Prototype& proto)
 
   /* Create new function type */
 
+  compiler::ReadOnlyEngine::check();
+
   const int id = static_cast<int>(d->prototypes.size());
   Type type{ id | Type::PrototypeFlag };
 
@@ -632,6 +738,8 @@ bool TypeSystem::isInitializerList(const Type& t) const
  */
 size_t TypeSystem::reserve(Type::TypeFlag flag, size_t count)
 {
+  compiler::ReadOnlyEngine::check();
+
   if (flag == Type::ObjectFlag)
   {
     size_t off = d->classes.size();
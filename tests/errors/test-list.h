@@ -0,0 +1,33 @@
+"/root/repo/tests/errors/test-array-elem-not-convertible.script",
+"/root/repo/tests/errors/test-array-invalid-subscript.script",
+"/root/repo/tests/errors/test-bad-array-init.script",
+"/root/repo/tests/errors/test-base-ctor-missing.script",
+"/root/repo/tests/errors/test-brace-init-narrowing.script",
+"/root/repo/tests/errors/test-copy-ctor-base-missing.script",
+"/root/repo/tests/errors/test-data-member-auto.script",
+"/root/repo/tests/errors/test-delegate-ctor-missing.script",
+"/root/repo/tests/errors/test-deleted-function.script",
+"/root/repo/tests/errors/test-enum-no-init.script",
+"/root/repo/tests/errors/test-function-invalid-default-arg.script",
+"/root/repo/tests/errors/test-function-variable-no-init.script",
+"/root/repo/tests/errors/test-illegal-this.script",
+"/root/repo/tests/errors/test-inheritance-base-ctor-deleted.script",
+"/root/repo/tests/errors/test-inheritance-invalid-base.script",
+"/root/repo/tests/errors/test-init-too-many-args.script",
+"/root/repo/tests/errors/test-invalid-op-overload.script",
+"/root/repo/tests/errors/test-invalid-use-delegated-ctor.script",
+"/root/repo/tests/errors/test-literal-operator-invalid.script",
+"/root/repo/tests/errors/test-member-init-bad-member.script",
+"/root/repo/tests/errors/test-member-init-inherited-member.script",
+"/root/repo/tests/errors/test-member-init-mutli-init.script",
+"/root/repo/tests/errors/test-no-destructor.script",
+"/root/repo/tests/errors/test-object-not-constructible.script",
+"/root/repo/tests/errors/test-private-member-1.script",
+"/root/repo/tests/errors/test-private-member-2.script",
+"/root/repo/tests/errors/test-private-member-3.script",
+"/root/repo/tests/errors/test-private-member-4.script",
+"/root/repo/tests/errors/test-ref-no-init.script",
+"/root/repo/tests/errors/test-return-missing-value.script",
+"/root/repo/tests/errors/test-return-unexpected-value.script",
+"/root/repo/tests/errors/test-static-data-member-no-init.script",
+"/root/repo/tests/errors/test-template-function.script",
@@ -92,6 +92,9 @@ int main(int argc, char **argv)
     "print",
     "builtin-types",
     "string",
+    "string-builder",
+    "string-view",
+    "map",
     "while",
     "for",
     "simple-functions",
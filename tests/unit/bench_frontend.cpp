@@ -0,0 +1,324 @@
+// Copyright (C) 2022 Vincent Chambrin
+// This file is part of the libscript library
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+// Measures the throughput of the front-end (Lexer, tokenize() and Parser)
+// on synthetic scripts, and on a given file if any.
+// Usage: BENCH_libscript_frontend [scale] [iterations] [file]
+// Results are written on the standard output, one JSON object per line.
+// The parallel parser is measured only on machines with several cores.
+
+#include "script/parser/lexer.h"
+#include "script/parser/parser.h"
+
+#include "script/ast/ast_p.h"
+#include "script/ast/visitor.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+
+namespace
+{
+
+class NodeCounter : public script::ast::AstVisitor
+{
+public:
+  size_t nodes = 0;
+
+  void visit(What, script::ast::NodeRef n) override
+  {
+    ++nodes;
+    recurse(n);
+  }
+
+  void visit(What, script::parser::Token) override { }
+};
+
+struct Corpus
+{
+  std::string name;
+  std::string source;
+};
+
+} // namespace
+
+static const char *sample_source =
+  "// computes some values\n"
+  "namespace bench\n"
+  "{\n"
+  "\n"
+  "class Point\n"
+  "{\n"
+  "public:\n"
+  "  int x = 0;\n"
+  "  int y = 0;\n"
+  "\n"
+  "  Point(int a, int b) : x(a), y(b) { }\n"
+  "  ~Point() = default;\n"
+  "\n"
+  "  int norm2() const { return x * x + y * y; }\n"
+  "};\n"
+  "\n"
+  "/* iterates over a range\n"
+  "   and accumulates the result */\n"
+  "int accumulate(const Array<int> & values, int initial_value)\n"
+  "{\n"
+  "  int result = initial_value;\n"
+  "  for(int i = 0; i < values.size(); ++i)\n"
+  "  {\n"
+  "    if (values[i] % 2 == 0 && values[i] != 0x1F)\n"
+  "      result += values[i] << 1;\n"
+  "    else\n"
+  "      result -= 3.14f * values[i];\n"
+  "  }\n"
+  "  return result;\n"
+  "}\n"
+  "\n"
+  "String greeting = \"Hello World!\";\n"
+  "\n"
+  "} // namespace bench\n";
+
+static std::string generate_sample(int scale)
+{
+  std::string result;
+
+  for (int i(0); i < 2000 * scale; ++i)
+    result += sample_source;
+
+  return result;
+}
+
+static std::string read_file(const char *path)
+{
+  std::ifstream file{ path };
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return buffer.str();
+}
+
+static std::string generate_functions(int scale)
+{
+  std::string result;
+
+  for (int i(0); i < 1000 * scale; ++i)
+  {
+    const std::string n = std::to_string(i);
+    result += "int f" + n + "(int a, const String& s)\n";
+    result += "{\n";
+    result += "  int r = a * " + n + " + s.size();\n";
+    result += "  if (r % 2 == 0) { r = r / 2; } else { r = 3 * r + 1; }\n";
+    result += "  return f" + std::to_string(i / 2) + "(r, s);\n";
+    result += "}\n\n";
+  }
+
+  return result;
+}
+
+static std::string generate_nesting(int scale)
+{
+  const int depth = 64;
+  std::string result;
+
+  for (int i(0); i < 20 * scale; ++i)
+  {
+    result += "void nested" + std::to_string(i) + "(int n)\n{\n";
+
+    for (int d(0); d < depth; ++d)
+      result += "for(int i" + std::to_string(d) + " = 0; i" + std::to_string(d) + " < n; ++i" + std::to_string(d) + ") { if (n > " + std::to_string(d) + ") {\n";
+
+    result += "n = (((n + 1) * (n - 1)) / ((n + 2) % (n + 3)));\n";
+
+    for (int d(0); d < depth; ++d)
+      result += "} }\n";
+
+    result += "}\n\n";
+  }
+
+  return result;
+}
+
+static std::string generate_classes(int scale)
+{
+  std::string result;
+
+  for (int i(0); i < 20 * scale; ++i)
+  {
+    const std::string n = std::to_string(i);
+    result += "class C" + n + "\n{\npublic:\n";
+    result += "  C" + n + "() = default;\n";
+    result += "  C" + n + "(const C" + n + "& other) = default;\n";
+    result += "  ~C" + n + "() { }\n\n";
+
+    for (int m(0); m < 100; ++m)
+    {
+      const std::string k = std::to_string(m);
+      result += "  int get" + k + "() const { return m" + k + "; }\n";
+      result += "  void set" + k + "(int v) { m" + k + " = v; }\n";
+      result += "  int add" + k + "(const C" + n + "& other) const { return m" + k + " + other.m" + k + "; }\n";
+    }
+
+    result += "\nprivate:\n";
+
+    for (int m(0); m < 100; ++m)
+      result += "  int m" + std::to_string(m) + " = " + std::to_string(m) + ";\n";
+
+    result += "};\n\n";
+  }
+
+  return result;
+}
+
+static std::string generate_templates(int scale)
+{
+  std::string result;
+
+  for (int i(0); i < 500 * scale; ++i)
+  {
+    const std::string n = std::to_string(i);
+    result += "template<typename T, typename U>\n";
+    result += "class Pair" + n + "\n{\npublic:\n";
+    result += "  T first;\n  U second;\n";
+    result += "  Pair" + n + "(const T& a, const U& b) : first(a), second(b) { }\n";
+    result += "};\n\n";
+    result += "template<typename T>\n";
+    result += "T max" + n + "(const T& a, const T& b) { return a < b ? b : a; }\n\n";
+    result += "Pair" + n + "<Array<int>, Pair" + n + "<int, String>> p" + n + " = make<Pair" + n + "<int, Array<Array<float>>>>(1, max" + n + "<int>(2, 3));\n\n";
+  }
+
+  return result;
+}
+
+static size_t count_nodes(const std::shared_ptr<script::ast::AST>& ast)
+{
+  NodeCounter counter;
+  script::ast::visit(counter, ast->root);
+  return counter.nodes;
+}
+
+static void report(const std::string& corpus, const std::string& stage, size_t bytes, size_t tokens, size_t nodes, double seconds)
+{
+  std::cout << "{\"corpus\": \"" << corpus << "\", \"stage\": \"" << stage << "\""
+    << ", \"bytes\": " << bytes
+    << ", \"tokens\": " << tokens
+    << ", \"nodes\": " << nodes
+    << ", \"seconds\": " << seconds
+    << ", \"tokens_per_second\": " << (seconds > 0 ? tokens / seconds : 0)
+    << ", \"nodes_per_second\": " << (seconds > 0 ? nodes / seconds : 0)
+    << "}" << std::endl;
+}
+
+static void run(const Corpus& corpus, int iterations)
+{
+  using namespace script;
+  using clock = std::chrono::high_resolution_clock;
+
+  const size_t bytes = corpus.source.size();
+  size_t tokens = 0;
+  // whitespace and comments are discarded before parsing
+  size_t parsed_tokens = 0;
+
+  {
+    auto start = clock::now();
+
+    for (int i(0); i < iterations; ++i)
+    {
+      parser::Lexer lexer{ corpus.source };
+
+      while (!lexer.atEnd())
+      {
+        lexer.read();
+        ++tokens;
+      }
+    }
+
+    tokens /= iterations;
+    const double seconds = std::chrono::duration<double>(clock::now() - start).count() / iterations;
+    report(corpus.name, "lexer", bytes, tokens, 0, seconds);
+  }
+
+  {
+    size_t count = 0;
+    auto start = clock::now();
+
+    for (int i(0); i < iterations; ++i)
+      count = parser::tokenize(corpus.source.data(), corpus.source.size()).size();
+
+    const double seconds = std::chrono::duration<double>(clock::now() - start).count() / iterations;
+    report(corpus.name, "tokenize", bytes, count, 0, seconds);
+    parsed_tokens = count;
+  }
+
+  {
+    SourceFile src = SourceFile::fromString(corpus.source);
+    size_t nodes = 0;
+    double seconds = 0;
+
+    for (int i(0); i < iterations; ++i)
+    {
+      auto start = clock::now();
+      std::shared_ptr<ast::AST> ast = parser::parse(src, 1);
+      seconds += std::chrono::duration<double>(clock::now() - start).count();
+
+      nodes = count_nodes(ast);
+    }
+
+    seconds /= iterations;
+    report(corpus.name, "parser", bytes, parsed_tokens, nodes, seconds);
+  }
+
+  const size_t threads = std::thread::hardware_concurrency();
+
+  if (threads > 1)
+  {
+    SourceFile src = SourceFile::fromString(corpus.source);
+    size_t nodes = 0;
+    double seconds = 0;
+
+    for (int i(0); i < iterations; ++i)
+    {
+      auto start = clock::now();
+      std::shared_ptr<ast::AST> ast = parser::parse(src, threads);
+      seconds += std::chrono::duration<double>(clock::now() - start).count();
+
+      nodes = count_nodes(ast);
+    }
+
+    seconds /= iterations;
+    report(corpus.name, "parser-parallel", bytes, parsed_tokens, nodes, seconds);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const int scale = argc > 1 ? std::stoi(argv[1]) : 1;
+  const int iterations = argc > 2 ? std::stoi(argv[2]) : 5;
+
+  std::vector<Corpus> corpora = {
+    { "sample", generate_sample(scale) },
+    { "functions", generate_functions(scale) },
+    { "nesting", generate_nesting(scale) },
+    { "classes", generate_classes(scale) },
+    { "templates", generate_templates(scale) },
+  };
+
+  if (argc > 3)
+    corpora.push_back({ argv[3], read_file(argv[3]) });
+
+  try
+  {
+    for (const Corpus& c : corpora)
+      run(c, iterations);
+  }
+  catch (const script::parser::SyntaxError& err)
+  {
+    std::cerr << "syntax error at offset " << err.offset << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -4,6 +4,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+
+#include "script/ast.h"
 #include "script/attributes.h"
 #include "script/cast.h"
 #include "script/class.h"
@@ -27,15 +30,22 @@
 
 #include "script/interpreter/executioncontext.h"
 
+#include "script/private/script_p.h"
+
 #include "script/compiler/compiler.h"
 #include "script/compiler/errors.h"
+#include "script/compiler/profiler.h"
 
 #include "script/program/expression.h"
 #include "script/program/statements.h"
 
 #include "script/parser/parser.h"
 
+#include <algorithm>
 #include <array>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 
 // @TODO: avoid calling run() in these tests, do that in the "language_test" target
 
@@ -1182,3 +1192,498 @@ TEST(CompilerTests, nativefunction) {
   ASSERT_EQ(x.type(), Type::Int);
   ASSERT_EQ(x.toInt(), 6);
 }
+
+
+TEST(CompilerTests, retention_policy) {
+  using namespace script;
+
+  const char* source =
+    " int foo(int a) { return a * 2; } \n"
+    " int n = foo(21);                   ";
+
+  Engine engine;
+  engine.setup();
+
+  Script a = engine.newScript(SourceFile::fromString(source));
+  ASSERT_TRUE(a.compile(CompileMode::Release));
+  ASSERT_FALSE(a.ast().isNull());
+  ASSERT_EQ(engine.retainedMemory(a).source, std::strlen(source));
+  ASSERT_TRUE(engine.retainedMemory(a).ast > 0);
+
+  Script b = engine.newScript(SourceFile::fromString(source));
+  ASSERT_TRUE(b.compile(CompileMode::Release, nullptr, RetentionPolicy::KeepSource));
+  ASSERT_TRUE(b.ast().isNull());
+  ASSERT_EQ(engine.retainedMemory(b).source, std::strlen(source));
+  ASSERT_EQ(engine.retainedMemory(b).ast, 0);
+
+  // the arena is kept alive by the attributes
+  const char* source_with_attributes = " [[no_discard]] int foo() { return 5; } ";
+  Script d = engine.newScript(SourceFile::fromString(source_with_attributes));
+  ASSERT_TRUE(d.compile(CompileMode::Release, nullptr, RetentionPolicy::KeepSource));
+  ASSERT_TRUE(d.ast().isNull());
+  ASSERT_TRUE(engine.retainedMemory(d).ast > 0);
+
+  Script c = engine.newScript(SourceFile::fromString(source));
+  ASSERT_TRUE(c.compile(CompileMode::Release, nullptr, RetentionPolicy::DropAll));
+  ASSERT_EQ(engine.retainedMemory(c).source, 0);
+  ASSERT_EQ(engine.retainedMemory(c).ast, 0);
+
+  c.run();
+  ASSERT_EQ(c.globals().front().toInt(), 42);
+}
+
+TEST(CompilerTests, incremental_recompilation) {
+  using namespace script;
+
+  const char* source =
+    " int foo(int a) { return a * 2; } \n"
+    " int bar() { return foo(21); }     \n"
+    " int n = bar();                    ";
+
+  Engine engine;
+  engine.setup();
+
+  Script s = engine.newScript(SourceFile::fromString(source));
+  ASSERT_TRUE(s.compile(CompileMode::Release));
+  s.run();
+  ASSERT_EQ(s.globals().front().toInt(), 42);
+
+  Function foo = s.functions().at(0);
+  Function bar = s.functions().at(1);
+  ASSERT_EQ(foo.name(), "foo");
+  ASSERT_EQ(bar.name(), "bar");
+
+  const char* updated_source =
+    " int foo(int a) { return a * 3; } \n"
+    " int bar() { return foo(21); }     \n"
+    " int n = bar();                    ";
+
+  // only the body of 'foo' changed, the functions are kept
+  ASSERT_TRUE(engine.recompile(s, SourceFile::fromString(updated_source)));
+  ASSERT_EQ(s.functions().size(), 2);
+  ASSERT_EQ(s.functions().at(0).impl(), foo.impl());
+  ASSERT_EQ(s.functions().at(1).impl(), bar.impl());
+  ASSERT_EQ(std::string(s.source().data(), s.source().size()), updated_source);
+
+  Value n = bar.invoke({});
+  ASSERT_EQ(n.toInt(), 63);
+  engine.destroy(n);
+
+  // a compilation error leaves the previous body in place
+  const char* invalid_source =
+    " int foo(int a) { return a * undefined_var; } \n"
+    " int bar() { return foo(21); }     \n"
+    " int n = bar();                    ";
+
+  ASSERT_FALSE(engine.recompile(s, SourceFile::fromString(invalid_source)));
+  ASSERT_FALSE(s.messages().empty());
+  ASSERT_EQ(std::string(s.source().data(), s.source().size()), updated_source);
+
+  n = bar.invoke({});
+  ASSERT_EQ(n.toInt(), 63);
+  engine.destroy(n);
+
+  // and so does a failure in another modified body
+  const char* partially_invalid_source =
+    " int foo(int a) { return a * 4; } \n"
+    " int bar() { return foo(undefined_var); } \n"
+    " int n = bar();                    ";
+
+  ASSERT_FALSE(engine.recompile(s, SourceFile::fromString(partially_invalid_source)));
+  ASSERT_EQ(std::string(s.source().data(), s.source().size()), updated_source);
+
+  n = bar.invoke({});
+  ASSERT_EQ(n.toInt(), 63);
+  engine.destroy(n);
+
+  // changing a global requires a full recompilation
+  const char* other_source =
+    " int foo(int a) { return a * 2; } \n"
+    " int bar() { return foo(21); }     \n"
+    " int n = bar() + 1;                ";
+
+  ASSERT_TRUE(engine.recompile(s, SourceFile::fromString(other_source)));
+  ASSERT_NE(s.functions().at(0).impl(), foo.impl());
+  s.run();
+  ASSERT_EQ(s.globals().front().toInt(), 43);
+
+  // so does a change that moves the lines of the functions
+  foo = s.functions().at(0);
+
+  const char* multiline_source =
+    " int foo(int a) {                  \n"
+    "   return a * 2; }                 \n"
+    " int bar() { return foo(21); }     \n"
+    " int n = bar() + 1;                ";
+
+  ASSERT_TRUE(engine.recompile(s, SourceFile::fromString(multiline_source)));
+  ASSERT_NE(s.functions().at(0).impl(), foo.impl());
+
+  // and any debug compilation
+  foo = s.functions().at(0);
+  ASSERT_TRUE(engine.recompile(s, SourceFile::fromString(multiline_source), CompileMode::Debug));
+  ASSERT_NE(s.functions().at(0).impl(), foo.impl());
+}
+
+TEST(CompilerTests, recompilation_of_a_rewritten_file) {
+  using namespace script;
+
+  const std::string path = testing::TempDir() + "recompilation_of_a_rewritten_file.script";
+
+  {
+    std::ofstream file{ path, std::ios::binary };
+    file << " int foo() { return 5; } ";
+  }
+
+  {
+    Engine engine;
+    engine.setup();
+
+    Script s = engine.newScript(SourceFile{ path });
+    ASSERT_TRUE(s.compile(CompileMode::Release));
+
+    Function foo = s.functions().front();
+    Value n = foo.invoke({});
+    ASSERT_EQ(n.toInt(), 5);
+    engine.destroy(n);
+
+    // rewritten in place, the compiled script does not see the change
+    {
+      std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+      file << " int foo() { return 6; } ";
+    }
+
+    ASSERT_EQ(std::string(s.source().data(), s.source().size()), " int foo() { return 5; } ");
+
+    ASSERT_TRUE(engine.recompile(s, SourceFile{ path }));
+    n = s.functions().front().invoke({});
+    ASSERT_EQ(n.toInt(), 6);
+    engine.destroy(n);
+
+    // a shorter file
+    {
+      std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+      file << "int foo(){return 7;}";
+    }
+
+    ASSERT_EQ(std::string(s.source().data(), s.source().size()), " int foo() { return 6; } ");
+
+    ASSERT_TRUE(engine.recompile(s, SourceFile{ path }));
+    n = s.functions().front().invoke({});
+    ASSERT_EQ(n.toInt(), 7);
+    engine.destroy(n);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST(CompilerTests, incremental_recompilation_with_attributes) {
+  using namespace script;
+
+  const std::string path = testing::TempDir() + "incremental_recompilation_with_attributes.script";
+
+  {
+    std::ofstream file{ path, std::ios::binary };
+    file << " [[no_discard]] int foo() { return 5; } \n int bar() { return 1; } ";
+  }
+
+  {
+    Engine engine;
+    engine.setup();
+
+    Script s = engine.newScript(SourceFile{ path });
+    ASSERT_TRUE(s.compile(CompileMode::Release));
+    Function foo = s.functions().front();
+
+    {
+      std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+      file << " [[no_discard]] int foo() { return 5; } \n int bar() { return 2; } ";
+    }
+
+    // 'foo' is not recompiled, its attributes reference the previous source
+    ASSERT_TRUE(engine.recompile(s, SourceFile{ path }));
+    ASSERT_EQ(s.functions().front().impl(), foo.impl());
+
+    Attributes attrs = foo.attributes();
+    ASSERT_EQ(attrs.size(), 1);
+    ASSERT_EQ(attrs.at(0)->source().toString(), "no_discard");
+  }
+
+  std::remove(path.c_str());
+}
+
+static std::string parallel_compilation_source(int error_index)
+{
+  std::string source = "class K { public: static int zero = 0; };\n";
+
+  for (int i(0); i < 100; ++i)
+  {
+    const std::string n = std::to_string(i);
+    source += "int f" + n + "(int a) {\n";
+
+    if (i == error_index)
+      source += "  a = undefined_variable;\n";
+
+    if (i % 10 == 5)
+      source += "  Array<Array<int>> arr; a = a + arr.size() + K::zero;\n";
+
+    source += "  return a + " + n + ";\n}\n";
+  }
+
+  return source;
+}
+
+TEST(CompilerTests, ast_nodes_outliving_the_ast) {
+  using namespace script;
+
+  Engine engine;
+  engine.setup();
+
+  {
+    const std::string path = testing::TempDir() + "ast_nodes_outliving_the_ast.script";
+
+    {
+      std::ofstream file{ path, std::ios::binary };
+      file << " [[no_discard]] int foo() { return 5; } ";
+    }
+
+    Script s = engine.newScript(SourceFile{ path });
+    ASSERT_TRUE(s.compile(CompileMode::Release, nullptr, RetentionPolicy::DropAll));
+    ASSERT_TRUE(s.ast().isNull());
+
+    // the source is kept for the attributes
+    ASSERT_TRUE(s.source().isLoaded());
+
+    Function foo = s.rootNamespace().functions().front();
+    Attributes attrs = foo.attributes();
+    ASSERT_EQ(attrs.size(), 1);
+    ASSERT_EQ(attrs.at(0)->source().toString(), "no_discard");
+
+    std::remove(path.c_str());
+  }
+
+  Template t;
+
+  {
+    Script s = engine.newScript(SourceFile::fromString("template<typename T = int> T id(T a) { return a; }"));
+    ASSERT_TRUE(s.compile());
+    t = s.rootNamespace().templates().front();
+    engine.destroy(s);
+  }
+
+  ASSERT_TRUE(t.parameters().front().hasDefaultValue());
+  t = Template{};
+
+  {
+    Script s = engine.newScript(SourceFile::fromString("int f() { return 1; } int g() { return h(); } int k() { return 2; }"));
+    ASSERT_FALSE(s.compile());
+    engine.destroy(s);
+  }
+
+  Script s = engine.newScript(SourceFile::fromString("int f() { return 1; }"));
+  ASSERT_TRUE(s.compile());
+}
+
+TEST(CompilerTests, parallel_compilation) {
+  using namespace script;
+
+  Engine engine;
+  engine.setup();
+  engine.compiler()->setThreadCount(4);
+
+  Script s = engine.newScript(SourceFile::fromString(parallel_compilation_source(-1)));
+  ASSERT_TRUE(s.compile());
+
+  const auto & functions = s.rootNamespace().functions();
+  ASSERT_EQ(functions.size(), 100);
+
+  for (int i(0); i < 100; ++i)
+  {
+    Value val = functions.at(i).invoke({ engine.newInt(1) });
+    ASSERT_EQ(val.toInt(), i + 1);
+    engine.destroy(val);
+  }
+
+  // diagnostics are the same as with a single thread
+  Script a = engine.newScript(SourceFile::fromString(parallel_compilation_source(60)));
+  ASSERT_FALSE(a.compile());
+
+  engine.compiler()->setThreadCount(1);
+
+  Script b = engine.newScript(SourceFile::fromString(parallel_compilation_source(60)));
+  ASSERT_FALSE(b.compile());
+
+  ASSERT_EQ(a.messages().size(), b.messages().size());
+  for (size_t i(0); i < a.messages().size(); ++i)
+    ASSERT_EQ(a.messages().at(i).to_string(), b.messages().at(i).to_string());
+}
+
+TEST(CompilerTests, lazy_compilation) {
+  using namespace script;
+
+  const char* source =
+    "class A { public: int n; A(int a) : n(a) { } ~A() { } int get() const { return n; } };"
+    "int f() { return 1; }"
+    "int g() { return f(1); }"
+    "int h() { A a{ 4 }; return f() + a.get(); }"
+    "int k() { return undefined_k; }";
+
+  Engine engine;
+  engine.setup();
+  engine.compiler()->setLazyCompilation(true);
+
+  Script s = engine.newScript(SourceFile::fromString(source));
+  ASSERT_TRUE(s.compile(CompileMode::Release, nullptr, RetentionPolicy::DropAll));
+
+  const auto& functions = s.rootNamespace().functions();
+  ASSERT_EQ(functions.size(), 4);
+  ASSERT_EQ(functions.at(2).name(), "h");
+
+  Value val = functions.at(2).invoke({});
+  ASSERT_EQ(val.toInt(), 5);
+  engine.destroy(val);
+
+  auto invocation_error = [](const Function& fun) -> std::string {
+    try
+    {
+      fun.invoke({});
+    }
+    catch (const RuntimeError& err)
+    {
+      return err.message;
+    }
+
+    return {};
+  };
+
+  ASSERT_EQ(functions.at(1).name(), "g");
+  const std::string g_error = invocation_error(functions.at(1));
+  ASSERT_FALSE(g_error.empty());
+  ASSERT_FALSE(s.messages().empty());
+  ASSERT_EQ(g_error, s.messages().front().to_string());
+
+  // each function reports its own error
+  ASSERT_EQ(functions.at(3).name(), "k");
+  const std::string k_error = invocation_error(functions.at(3));
+  ASSERT_FALSE(k_error.empty());
+  ASSERT_NE(k_error, g_error);
+  ASSERT_EQ(k_error, s.messages().back().to_string());
+
+  // the error is reported once
+  const size_t message_count = s.messages().size();
+  ASSERT_EQ(invocation_error(functions.at(1)), g_error);
+  ASSERT_EQ(s.messages().size(), message_count);
+
+  ASSERT_FALSE(s.compileAll());
+  ASSERT_EQ(s.messages().size(), message_count);
+
+  // the ast and the source are released once no function is deferred
+  ASSERT_TRUE(s.impl()->deferred_functions_index.empty());
+  ASSERT_TRUE(s.ast().isNull());
+  ASSERT_FALSE(s.source().isLoaded());
+
+  Script t = engine.newScript(SourceFile::fromString("int f() { return 1; } int g() { return f() + 1; }"));
+  ASSERT_TRUE(t.compile(CompileMode::Release, nullptr, RetentionPolicy::KeepSource));
+  ASSERT_FALSE(t.ast().isNull());
+  ASSERT_TRUE(t.compileAll());
+  ASSERT_TRUE(t.impl()->deferred_functions.empty());
+  ASSERT_TRUE(t.ast().isNull());
+  ASSERT_TRUE(t.source().isLoaded());
+}
+
+TEST(CompilerTests, local_variable_shadowing) {
+  using namespace script;
+
+  const char* source =
+    "int f(int a) {"
+    "  int b = a;"
+    "  {"
+    "    int a = 10;"
+    "    b = b + a;"
+    "    {"
+    "      int b = 100;"
+    "      a = a + b;"
+    "    }"
+    "    b = b + a;"
+    "  }"
+    "  for (int a = 0; a < 2; ++a) { int c = a; b = b + c; }"
+    "  return a + b;"
+    "}";
+
+  Engine engine;
+  engine.setup();
+
+  Script s = engine.newScript(SourceFile::fromString(source));
+  ASSERT_TRUE(s.compile());
+
+  Value val = s.rootNamespace().functions().front().invoke({ engine.newInt(1) });
+  ASSERT_EQ(val.toInt(), 1 + (1 + 10 + 110 + 1));
+  engine.destroy(val);
+}
+
+TEST(CompilerTests, profiler) {
+  using namespace script;
+
+  const char* source =
+    "class A { public: int n; A(int a) : n(a) { } ~A() { } };"
+    "template<typename T> T id(T a) { return a; }"
+    "int f(int a, int b = 2) { return a + b; }"
+    "int g() { A a{ 4 }; return f(a.n) + id(1); }";
+
+  Engine engine;
+  engine.setup();
+
+  compiler::Profiler& profiler = engine.compiler()->profiler();
+  ASSERT_FALSE(profiler.isEnabled());
+  profiler.setEnabled(true);
+
+  Script s = engine.newScript(SourceFile::fromString(source));
+  ASSERT_TRUE(s.compile());
+
+  using Phase = compiler::Profiler::Phase;
+  ASSERT_EQ(profiler.counter(Phase::Compilation).count, 1);
+  ASSERT_EQ(profiler.counter(Phase::Parsing).count, 1);
+  ASSERT_GE(profiler.counter(Phase::Declarations).count, 4);
+  ASSERT_GE(profiler.counter(Phase::DefaultArguments).count, 1);
+  ASSERT_GE(profiler.counter(Phase::FunctionBodies).count, 4);
+  ASSERT_EQ(profiler.counter(Phase::TemplateInstantiation).count, 1);
+  ASSERT_GT(profiler.counter(Phase::NameLookup).count, 0);
+  ASSERT_LE(profiler.counter(Phase::FunctionBodies).time, profiler.counter(Phase::Compilation).time);
+
+  std::vector<compiler::Profiler::Event> declarations = profiler.slowest(Phase::Declarations, 2);
+  ASSERT_EQ(declarations.size(), 2);
+  ASSERT_GE(declarations.front().duration, declarations.back().duration);
+
+  auto it = std::find_if(profiler.events().begin(), profiler.events().end(), [](const compiler::Profiler::Event& e) {
+    return e.phase == Phase::Declarations && e.name == "class A";
+  });
+  ASSERT_TRUE(it != profiler.events().end());
+
+  std::ostringstream trace;
+  profiler.writeChromeTrace(trace);
+  ASSERT_EQ(trace.str().find("{\"traceEvents\":[{\"name\":"), 0);
+  ASSERT_NE(trace.str().find("\"cat\":\"template instantiation\""), std::string::npos);
+
+  profiler.clear();
+  profiler.setEnabled(false);
+
+  Script t = engine.newScript(SourceFile::fromString("int h() { return 0; }"));
+  ASSERT_TRUE(t.compile());
+  ASSERT_TRUE(profiler.events().empty());
+  ASSERT_EQ(profiler.counter(Phase::NameLookup).count, 0);
+
+  // the number of stored events is bounded
+  const size_t max_events = compiler::Profiler::MaxEvents;
+  compiler::Profiler::setCurrent(&profiler);
+
+  for (size_t i(0); i <= max_events; ++i)
+    compiler::Profiler::Timer timer{ Phase::FunctionBodies };
+
+  compiler::Profiler::setCurrent(nullptr);
+  ASSERT_EQ(profiler.events().size(), max_events);
+  ASSERT_EQ(profiler.droppedEvents(), 1);
+  ASSERT_EQ(profiler.counter(Phase::FunctionBodies).count, max_events + 1);
+
+  profiler.clear();
+  ASSERT_EQ(profiler.droppedEvents(), 0);
+}
@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 
 #include "script/engine.h"
@@ -52,6 +53,8 @@ TEST(CoreUtilsTests, SourceFile) {
   s = SourceFile{ "temp.txt" };
   ASSERT_NO_THROW(s.load());
   ASSERT_STREQ(content, s.data());
+  ASSERT_EQ(s.size(), std::strlen(content));
+  ASSERT_EQ(s.content(), std::string(content));
   s.unload();
   ASSERT_NO_THROW(s.load());
   s.unload();
@@ -62,6 +65,33 @@ TEST(CoreUtilsTests, SourceFile) {
   ASSERT_ANY_THROW(s.load());
 }
 
+TEST(CoreUtilsTests, SourceFile_map) {
+  using namespace script;
+
+  SourceFile s = SourceFile::fromString("int a;\n\n  int b;\nint c;");
+
+  SourceFile::Position pos = s.map(0);
+  ASSERT_EQ(pos.line, 0);
+  ASSERT_EQ(pos.col, 0);
+
+  pos = s.map(6); // first line break
+  ASSERT_EQ(pos.line, 0);
+  ASSERT_EQ(pos.col, 6);
+
+  pos = s.map(7); // empty line
+  ASSERT_EQ(pos.line, 1);
+  ASSERT_EQ(pos.col, 0);
+
+  pos = s.map(10); // 'int b'
+  ASSERT_EQ(pos.line, 2);
+  ASSERT_EQ(pos.col, 2);
+  ASSERT_EQ(pos.pos, 10);
+
+  pos = s.map(17); // 'int c'
+  ASSERT_EQ(pos.line, 3);
+  ASSERT_EQ(pos.col, 0);
+}
+
 
 
 TEST(CoreUtilsTests, array_creation) {
@@ -10,8 +10,11 @@
 #include "script/context.h"
 #include "script/function.h"
 #include "script/script.h"
+#include "script/stringview.h"
 #include "script/value.h"
 
+#include <stdexcept>
+
 TEST(Eval, test1) {
   using namespace script;
 
@@ -86,6 +89,24 @@ TEST(Eval, conditional_expression) {
   ASSERT_EQ(x.toInt(), 1);
 }
 
+TEST(Eval, stringview_at) {
+  using namespace script;
+
+  Engine engine;
+  engine.setup();
+
+  Value s = engine.eval("s = \"abc\"");
+  ASSERT_THROW(StringView(s).at(3), std::out_of_range);
+  ASSERT_EQ(StringView(s).substr(1).at(1), 'c');
+  ASSERT_THROW(StringView(s).substr(1).at(2), std::out_of_range);
+
+  Value c = engine.eval("StringView(s).at(2)");
+  ASSERT_EQ(c.toChar(), 'c');
+  ASSERT_ANY_THROW(engine.eval("StringView(s).at(3)"));
+  ASSERT_EQ(engine.eval("StringView(s)[1]").toChar(), 'b');
+  ASSERT_ANY_THROW(engine.eval("StringView(s)[-1]"));
+}
+
 TEST(Engine, references_1) {
   using namespace script;
 
@@ -52,6 +52,34 @@ TEST(LexerTests, keywords) {
 }
 
 
+TEST(LexerTests, keywords_near_miss) {
+  using namespace script;
+  using namespace parser;
+
+  const char *source =
+    "iff fo in autos boo chars els enums thi tru voids breaks klass cons falsy flat use whil "
+    " delet doubles exports friends imports publik returns statik structs typeids defaults "
+    " mutabl privat typedefs virtua continu explicite operators templat typenames namespac protecte "
+    " this const virtual typename delete /* comment */ mutable // comment \n default";
+
+  Lexer lex{ source };
+  for (int i(0); i < 40; ++i)
+    ASSERT_EQ(lex.read(), Token::UserDefinedName);
+
+  ASSERT_EQ(lex.read(), Token::This);
+  ASSERT_EQ(lex.read(), Token::Const);
+  ASSERT_EQ(lex.read(), Token::Virtual);
+  ASSERT_EQ(lex.read(), Token::Typename);
+  ASSERT_EQ(lex.read(), Token::Delete);
+  ASSERT_EQ(lex.read(), Token::MultiLineComment);
+  ASSERT_EQ(lex.read(), Token::Mutable);
+  ASSERT_EQ(lex.read(), Token::SingleLineComment);
+  ASSERT_EQ(lex.read(), Token::Default);
+
+  ASSERT_TRUE(lex.atEnd());
+}
+
+
 TEST(LexerTests, literals) {
   using namespace script;
   using namespace parser;
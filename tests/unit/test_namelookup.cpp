@@ -152,6 +152,30 @@ TEST(NameLookup, operators) {
   ASSERT_EQ(lookup.functions().size(), 5);
 }
 
+TEST(NameLookup, binary_operators) {
+  using namespace script;
+
+  Engine e;
+  e.setup();
+
+  Scope scp{ e.rootNamespace() };
+
+  std::vector<Function> candidates = NameLookup::resolve(AdditionOperator, Type::Int, Type::cref(Type::Int), scp);
+  ASSERT_EQ(candidates.size(), 1);
+  ASSERT_EQ(candidates.front().parameter(0).baseType(), Type::Int);
+  ASSERT_EQ(candidates.front().parameter(1).baseType(), Type::Int);
+
+  // no exact match, every addition operator is a candidate, but only once
+  candidates = NameLookup::resolve(AdditionOperator, Type::Int, Type::Float, scp);
+  ASSERT_EQ(candidates.size(), scp.lookup(AdditionOperator).size());
+
+  // operators added after a lookup are found by the next one
+  Function op = FunctionBuilder::Op(e.rootNamespace(), AdditionOperator).returns(Type::Int).params(Type::Int, Type::Int).get();
+  candidates = NameLookup::resolve(AdditionOperator, Type::Int, Type::Int, scp);
+  ASSERT_EQ(candidates.size(), 2);
+  ASSERT_EQ(candidates.back(), op);
+}
+
 TEST(NameLookup, parsing_operator_name) {
   using namespace script;
 
@@ -435,3 +459,80 @@ TEST(NameLookup, scope_namespace_alias) {
 
   ASSERT_ANY_THROW(s.inject(NamespaceAlias{ "b", { "bla" } }));
 }
+
+TEST(NameLookup, scope_injection_is_persistent) {
+  // Injecting names in a copy of a scope does not modify the original scope
+  using namespace script;
+
+  Engine e;
+  e.setup();
+
+  Namespace foo = e.rootNamespace().newNamespace("foo");
+  Class foo_A = ClassBuilder(Symbol(foo), "A").get();
+  Namespace foo_qux = foo.newNamespace("qux");
+  Function func = FunctionBuilder::Fun(foo_qux, "func").get();
+  Namespace bar = e.rootNamespace().newNamespace("bar");
+
+  Scope s = Scope{ e.rootNamespace() }.child("bar");
+
+  Scope t = s;
+  t.inject(foo_A);
+  ASSERT_EQ(t.lookup("A").resultType(), NameLookup::TypeName);
+  ASSERT_EQ(s.lookup("A").resultType(), NameLookup::UnknownName);
+  ASSERT_EQ(t.parent().impl(), s.parent().impl());
+
+  Scope u = t;
+  u.inject(std::string("Distance"), Type{ Type::Double });
+  ASSERT_EQ(u.lookup("A").resultType(), NameLookup::TypeName);
+  ASSERT_EQ(u.lookup("Distance").resultType(), NameLookup::TypeName);
+  ASSERT_EQ(t.lookup("Distance").resultType(), NameLookup::UnknownName);
+
+  Scope v = s;
+  v.inject(NamespaceAlias{ "fq", { "foo", "qux" } });
+  ASSERT_EQ(NameLookup::resolve("fq::func", v).resultType(), NameLookup::FunctionName);
+  ASSERT_EQ(NameLookup::resolve("fq::func", s).resultType(), NameLookup::UnknownName);
+  ASSERT_EQ(NameLookup::resolve("fq::func", Scope{ e.rootNamespace() }).resultType(), NameLookup::UnknownName);
+}
+
+TEST(NameLookup, large_namespace) {
+  using namespace script;
+
+  Engine e;
+  e.setup();
+
+  Namespace ns = e.rootNamespace().newNamespace("bindings");
+  Class c = ns.newClass("C").get();
+
+  for (int i(0); i < 2000; ++i)
+  {
+    FunctionBuilder::Fun(ns, "f" + std::to_string(i)).create();
+    FunctionBuilder::Fun(c, "g" + std::to_string(i)).create();
+  }
+
+  NameLookup lookup = NameLookup::resolve("bindings::f1234", e.rootNamespace());
+  ASSERT_EQ(lookup.resultType(), NameLookup::FunctionName);
+  ASSERT_EQ(lookup.functions().size(), 1);
+  ASSERT_EQ(lookup.functions().front(), ns.functions().at(1234));
+
+  lookup = NameLookup::resolve("bindings::f2000", e.rootNamespace());
+  ASSERT_EQ(lookup.resultType(), NameLookup::UnknownName);
+
+  /* Symbols added after a lookup are found by the next one */
+  FunctionBuilder::Fun(ns, "f2000").create();
+  FunctionBuilder::Fun(ns, "f1234").params(Type::Int).create();
+  Class d = ns.newClass("f1999").get();
+
+  lookup = NameLookup::resolve("bindings::f2000", e.rootNamespace());
+  ASSERT_EQ(lookup.resultType(), NameLookup::FunctionName);
+
+  lookup = NameLookup::resolve("bindings::f1234", e.rootNamespace());
+  ASSERT_EQ(lookup.functions().size(), 2);
+
+  lookup = NameLookup::resolve("bindings::f1999", e.rootNamespace());
+  ASSERT_EQ(lookup.resultType(), NameLookup::TypeName);
+  ASSERT_EQ(lookup.typeResult(), d.id());
+
+  lookup = NameLookup::member("g1500", c);
+  ASSERT_EQ(lookup.resultType(), NameLookup::FunctionName);
+  ASSERT_EQ(lookup.functions().size(), 1);
+}
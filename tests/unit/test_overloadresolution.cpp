@@ -17,6 +17,8 @@
 
 #include "script/functionbuilder.h"
 
+#include "script/private/engine_p.h"
+
 TEST(OverloadResolution, test1) {
   using namespace script;
 
@@ -104,3 +106,51 @@ TEST(OverloadResolution, failure_no_viable_candidates) {
 
   // @TODO: test that OR fails because argument are missing or not convertible
 }
+
+TEST(OverloadResolution, cache) {
+  using namespace script;
+
+  Engine e;
+  e.setup();
+
+  Class A = ClassBuilder(Symbol(e.rootNamespace()), "A").get();
+
+  std::vector<Function> overloads;
+  overloads.push_back(FunctionBuilder::Fun(e.rootNamespace(), "foo").params(Type::cref(A.id())).get());
+  overloads.push_back(FunctionBuilder::Fun(e.rootNamespace(), "foo").params(Type::Float).get());
+
+  OverloadResolution::Candidate resol = resolve_overloads(overloads, std::vector<Type>{ Type::Int });
+  ASSERT_TRUE(bool(resol));
+  ASSERT_EQ(resol.function, overloads.at(1));
+  ASSERT_EQ(e.implementation()->overload_resolution_cache.size(), 1);
+
+  resol = resolve_overloads(overloads, std::vector<Type>{ Type::Int });
+  ASSERT_EQ(resol.function, overloads.at(1));
+  ASSERT_EQ(resol.initializations.size(), 1);
+  ASSERT_EQ(e.implementation()->overload_resolution_cache.size(), 1);
+
+  overloads.pop_back();
+  resol = resolve_overloads(overloads, std::vector<Type>{ Type::Int });
+  ASSERT_FALSE(bool(resol));
+  ASSERT_EQ(e.implementation()->overload_resolution_cache.size(), 2);
+
+  // adding a function with another name keeps the results
+  FunctionBuilder::Fun(e.rootNamespace(), "bar").params(Type::Int).create();
+  ASSERT_EQ(e.implementation()->overload_resolution_cache.size(), 2);
+
+  // but not an overload of a cached candidate
+  FunctionBuilder::Fun(e.rootNamespace(), "foo").params(Type::Int).create();
+  ASSERT_EQ(e.implementation()->overload_resolution_cache.size(), 0);
+
+  resol = resolve_overloads(overloads, std::vector<Type>{ Type::Int });
+  ASSERT_FALSE(bool(resol));
+  ASSERT_EQ(e.implementation()->overload_resolution_cache.size(), 1);
+
+  // adding a converting constructor invalidates the cache
+  FunctionBuilder::Constructor(A).params(Type::Int).create();
+  ASSERT_EQ(e.implementation()->overload_resolution_cache.size(), 0);
+
+  resol = resolve_overloads(overloads, std::vector<Type>{ Type::Int });
+  ASSERT_TRUE(bool(resol));
+  ASSERT_EQ(resol.function, overloads.at(0));
+}
@@ -3,9 +3,11 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <gtest/gtest.h>
+#include <cstring>
 
 #include "script/parser/parser.h"
 #include "script/parser/specific-parsers.h"
+#include "script/parser/token-stream.h"
 
 #include "script/ast.h"
 #include "script/ast/node.h"
@@ -1325,3 +1327,159 @@ TEST(ParserTests, visitall) {
   }
 
 }
+
+
+TEST(ParserTests, arena) {
+  using namespace script;
+
+  std::shared_ptr<ast::Declaration> decl;
+  std::shared_ptr<ast::Statement> stmt;
+  std::weak_ptr<ast::Arena> arena;
+
+  {
+    SourceFile src = SourceFile::fromString("int foo(int a, int b) { return a + b * 2; }");
+    Ast syntaxtree = ast::parse(src);
+
+    ASSERT_TRUE(syntaxtree.impl()->arena != nullptr);
+    ASSERT_TRUE(syntaxtree.impl()->arena->bytesAllocated() > 0);
+    ASSERT_TRUE(syntaxtree.impl()->arena->bytesAllocated() <= syntaxtree.impl()->arena->bytesReserved());
+
+    decl = syntaxtree.declarations().front();
+    stmt = syntaxtree.statements().front();
+    arena = syntaxtree.impl()->arena;
+  }
+
+  // the nodes keep the arena alive
+  ASSERT_FALSE(arena.expired());
+  ASSERT_TRUE(decl->is<ast::FunctionDecl>());
+  ASSERT_EQ(decl->as<ast::FunctionDecl>().params.size(), 2);
+  ASSERT_EQ(stmt->type(), ast::NodeType::FunctionDeclaration);
+
+  decl = nullptr;
+  ASSERT_FALSE(arena.expired());
+  stmt = nullptr;
+  ASSERT_TRUE(arena.expired());
+
+  // nodes created outside of a parse are not allocated in an arena
+  ASSERT_EQ(ast::Arena::current(), nullptr);
+}
+
+TEST(ParserTests, token_stream) {
+  using namespace script;
+  using namespace parser;
+
+  const char *source =
+    "int a = 5; /* comment */ \n"
+    "int foo(int n) { return n; } \n"
+    "if(a) { a = 1; } else { a = 2; } \n"
+    "A b = A{1} + A{2}; \n"
+    "namespace N { int c = 0; }; \n"
+    "foo(a);";
+
+  TokenStream stream{ source, std::strlen(source) };
+  std::vector<Token> tokens;
+  std::vector<std::string> statements;
+
+  while (stream.readStatement(tokens))
+  {
+    const char *begin = tokens.front().text().data();
+    const char *end = tokens.back().text().data() + tokens.back().text().size();
+    statements.push_back(std::string(begin, end));
+  }
+
+  ASSERT_TRUE(stream.atEnd());
+  ASSERT_EQ(statements.size(), 6);
+  ASSERT_EQ(statements.at(0), "int a = 5;");
+  ASSERT_EQ(statements.at(1), "int foo(int n) { return n; }");
+  ASSERT_EQ(statements.at(2), "if(a) { a = 1; } else { a = 2; }");
+  ASSERT_EQ(statements.at(3), "A b = A{1} + A{2};");
+  ASSERT_EQ(statements.at(4), "namespace N { int c = 0; };");
+  ASSERT_EQ(statements.at(5), "foo(a);");
+
+  Ast syntaxtree = ast::parse(SourceFile::fromString(source));
+  ASSERT_EQ(syntaxtree.statements().size(), 7);
+  ASSERT_EQ(syntaxtree.declarations().size(), 4);
+}
+
+TEST(ParserTests, parallel_parsing) {
+  using namespace script;
+
+  std::string source;
+  for (int i(0); i < 200; ++i)
+  {
+    const std::string n = std::to_string(i);
+    source += "int foo" + n + "(int a) { if(a > 0) { return a; } else { return -a; } } \n";
+    source += "int var" + n + " = foo" + n + "(" + n + "); \n";
+  }
+
+  SourceFile src = SourceFile::fromString(source);
+  std::shared_ptr<ast::AST> sequential = parser::parse(src, 1);
+  std::shared_ptr<ast::AST> parallel = parser::parse(src, 4);
+
+  const auto& expected = sequential->root->as<ast::ScriptRootNode>().statements;
+  const auto& actual = parallel->root->as<ast::ScriptRootNode>().statements;
+  ASSERT_EQ(actual.size(), 400);
+  ASSERT_EQ(actual.size(), expected.size());
+  ASSERT_EQ(parallel->root->as<ast::ScriptRootNode>().declarations.size(), 400);
+
+  for (size_t i(0); i < actual.size(); ++i)
+  {
+    ASSERT_EQ(actual.at(i)->type(), expected.at(i)->type());
+    ASSERT_EQ(actual.at(i)->source(), expected.at(i)->source());
+  }
+
+  ASSERT_EQ(parallel->arena->bytesAllocated(), sequential->arena->bytesAllocated());
+
+  // the first syntax error in the source is reported
+  source += "int bar() { return 0 } \n";
+  source += "int qux() { return 0 } \n";
+  src = SourceFile::fromString(source);
+
+  size_t expected_offset = 0;
+
+  try
+  {
+    parser::parse(src, 1);
+    ASSERT_TRUE(false);
+  }
+  catch (const parser::SyntaxError& err)
+  {
+    expected_offset = err.offset;
+  }
+
+  try
+  {
+    parser::parse(src, 4);
+    ASSERT_TRUE(false);
+  }
+  catch (const parser::SyntaxError& err)
+  {
+    ASSERT_EQ(err.offset, expected_offset);
+  }
+}
+
+TEST(ParserTests, nested_template_arguments) {
+  using namespace script;
+
+  // each template argument is first tried as a type, then reparsed as an 
+  // expression; without memoization, this takes time exponential in the depth
+  std::string source = "int z = ";
+  for (int i(0); i < 32; ++i)
+    source += "A<";
+  source += "x";
+  for (int i(0); i < 32; ++i)
+    source += ">+1";
+  source += ";";
+
+  Ast syntaxtree = ast::parse(SourceFile::fromString(source));
+  ASSERT_EQ(syntaxtree.declarations().size(), 1);
+  ASSERT_TRUE(syntaxtree.declarations().front()->is<ast::VariableDecl>());
+
+  auto& decl = syntaxtree.declarations().front()->as<ast::VariableDecl>();
+  ASSERT_TRUE(decl.init->is<ast::AssignmentInitialization>());
+  auto& init = decl.init->as<ast::AssignmentInitialization>();
+  ASSERT_TRUE(init.value->is<ast::Operation>());
+  auto& op = init.value->as<ast::Operation>();
+  ASSERT_TRUE(op.arg1->is<ast::TemplateIdentifier>());
+  ASSERT_TRUE(op.arg1->as<ast::TemplateIdentifier>().arguments.front()->is<ast::Operation>());
+}
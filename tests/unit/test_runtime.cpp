@@ -4,6 +4,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+
 #include "script/class.h"
 #include "script/classbuilder.h"
 #include "script/engine.h"
@@ -123,3 +126,36 @@ TEST(TestRuntime, debugcompilation) {
   ASSERT_TRUE(debug_handler->name == "a");
   ASSERT_TRUE(debug_handler->value == 5);
 }
+
+TEST(TestRuntime, debugcompilation_from_file) {
+  using namespace script;
+
+  const char* source =
+    "void main()   \n"
+    "{             \n"
+    "  int a = 5;  \n"
+    "  int b = 2;  \n"
+    "  a = a + b;  \n"
+    "}             \n";
+
+  const std::string path = testing::TempDir() + "debugcompilation_from_file.script";
+
+  {
+    std::ofstream file{ path, std::ios::binary };
+    file << source;
+  }
+
+  {
+    Engine engine;
+    engine.setup();
+
+    Script s = engine.newScript(SourceFile{ path });
+    ASSERT_TRUE(s.compile(CompileMode::Debug));
+
+    ASSERT_EQ(s.breakpoints(3).size(), 1);
+    ASSERT_EQ(s.breakpoints(4).size(), 1);
+    ASSERT_EQ(s.breakpoints(5).size(), 1);
+  }
+
+  std::remove(path.c_str());
+}
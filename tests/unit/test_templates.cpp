@@ -6,6 +6,7 @@
 
 #include "script/array.h"
 #include "script/class.h"
+#include "script/classbuilder.h"
 #include "script/conversions.h"
 #include "script/engine.h"
 #include "script/functionbuilder.h"
@@ -1131,3 +1132,44 @@ TEST(TemplateTests, full_spec_overload_selec) {
   ASSERT_EQ(result.second.size(), 1);
   ASSERT_EQ(result.second.front().type, Type::Int);
 }
+
+TEST(TemplateTests, instance_table) {
+  using namespace script;
+
+  Engine engine;
+  engine.setup();
+
+  TemplateInstanceTable<Class> table;
+  Class value;
+
+  std::vector<Class> classes;
+  for (int i(0); i < 20; ++i)
+  {
+    Class c = engine.rootNamespace().newClass("C" + std::to_string(i)).get();
+    table.insert({ TemplateArgument{ c.id() } }, c);
+    classes.push_back(c);
+  }
+
+  table.insert({ TemplateArgument{ Type::Int }, TemplateArgument{ 3 } }, classes.front());
+  ASSERT_EQ(table.size(), 21);
+
+  for (const Class & c : classes)
+  {
+    ASSERT_TRUE(table.find({ TemplateArgument{ c.id() } }, &value));
+    ASSERT_EQ(value, c);
+  }
+
+  ASSERT_TRUE(table.find({ TemplateArgument{ Type::Int }, TemplateArgument{ 3 } }, &value));
+  ASSERT_FALSE(table.find({ TemplateArgument{ Type::Int }, TemplateArgument{ 4 } }, &value));
+  ASSERT_FALSE(table.find({ TemplateArgument{ Type::Int } }, &value));
+
+  table.erase({ TemplateArgument{ classes.at(3).id() } });
+  ASSERT_FALSE(table.find({ TemplateArgument{ classes.at(3).id() } }, &value));
+  ASSERT_TRUE(table.find({ TemplateArgument{ classes.at(4).id() } }, &value));
+  ASSERT_EQ(value, classes.at(4));
+
+  table.insert({ TemplateArgument{ classes.at(4).id() } }, classes.at(5));
+  ASSERT_TRUE(table.find({ TemplateArgument{ classes.at(4).id() } }, &value));
+  ASSERT_EQ(value, classes.at(5));
+  ASSERT_EQ(table.size(), 20);
+}
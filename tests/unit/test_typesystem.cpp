@@ -22,6 +22,8 @@
 #include "script/typesystem.h"
 #include "script/typesystemtransaction.h"
 
+#include "script/private/typesystem_p.h"
+
 TEST(TypeSystemTests, Types) {
   using namespace script;
 
@@ -425,6 +427,51 @@ TEST(Conversions, explicit_ctor) {
   ASSERT_EQ(conv.userDefinedConversion(), ctor_int);
 }
 
+TEST(Conversions, cache) {
+  using namespace script;
+
+  Engine e;
+  e.setup();
+
+  Class A = ClassBuilder(Symbol(e.rootNamespace()), "A").get();
+  Class B = ClassBuilder(Symbol(e.rootNamespace()), "B").get();
+
+  ConversionCache& cache = e.typeSystem()->impl()->conversions;
+  ASSERT_EQ(cache.size(), 0);
+
+  Conversion conv = Conversion::compute(A.id(), B.id(), &e);
+  ASSERT_TRUE(conv == Conversion::NotConvertible());
+  ASSERT_NE(cache.size(), 0);
+
+  conv = Conversion::compute(A.id(), B.id(), &e);
+  ASSERT_TRUE(conv == Conversion::NotConvertible());
+
+  Function ctor = FunctionBuilder::Constructor(B).params(Type::cref(A.id())).get();
+  ASSERT_EQ(cache.size(), 0);
+
+  conv = Conversion::compute(A.id(), B.id(), &e);
+  ASSERT_EQ(conv.userDefinedConversion(), ctor);
+
+  // creating a type keeps the results
+  const size_t size = cache.size();
+  Class D = ClassBuilder(Symbol(e.rootNamespace()), "D").get();
+  ASSERT_EQ(cache.size(), size);
+
+  Conversion::compute(D.id(), B.id(), &e);
+  Conversion::compute(Type::cref(B.id()), Type::ref(D.id()), &e);
+  ASSERT_GT(cache.size(), size);
+
+  // destroying a type only removes the results involving it
+  e.typeSystem()->impl()->destroy(D);
+  ASSERT_EQ(cache.size(), size);
+
+  Class C = ClassBuilder(Symbol(e.rootNamespace()), "C").setBase(A).get();
+  ASSERT_EQ(cache.size(), 0);
+
+  ASSERT_TRUE(e.canConvert(C.id(), Type::cref(A.id())));
+  ASSERT_TRUE(e.canConvert(C.id(), Type::cref(A.id())));
+}
+
 TEST(Conversions, engine_functions) {
   using namespace script;
 